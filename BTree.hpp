@@ -0,0 +1,554 @@
+#pragma once
+#ifndef BTREE_HPP
+#define BTREE_HPP
+
+# include <memory>
+# include <cstddef>
+# include <type_traits>
+# include <utility>
+# include "Iterator.hpp"
+# include "Utility.hpp"
+
+namespace ft {
+	/*
+	** B+ tree backing ft::BTreeMap and ft::BTreeSet. Values live in leaves
+	** that are chained in key order; internal nodes only hold separator keys,
+	** where child i holds keys below keys[i] and child i + 1 the rest. Nodes
+	** are sized to about NodeBytes so one node spans a few cache lines.
+	** Inserting or erasing shifts values inside a leaf, so unlike ft::Map it
+	** invalidates iterators into the touched leaves.
+	*/
+	template <class Value, class Key, class KeyOfValue, class Compare, class A>
+	class BTree {
+	public:
+		static const std::size_t	NodeBytes = 256;
+
+		struct Internal_;
+		struct Node_ {
+			Internal_		*parent;
+			unsigned short	position;
+			unsigned short	count;
+			bool			leaf;
+		};
+
+		static const unsigned short	LeafSlots = (NodeBytes - sizeof(Node_) - 2 * sizeof(void*)) / sizeof(Value) > 4
+											? (NodeBytes - sizeof(Node_) - 2 * sizeof(void*)) / sizeof(Value) : 4;
+		static const unsigned short	InnerSlots = (NodeBytes - sizeof(Node_)) / (sizeof(Key) + sizeof(void*)) > 4
+											? (NodeBytes - sizeof(Node_)) / (sizeof(Key) + sizeof(void*)) : 4;
+		static const unsigned short	LeafMin = LeafSlots / 2;
+		static const unsigned short	InnerMin = InnerSlots / 2;
+
+		struct Leaf_ : public Node_ {
+			Leaf_			*prev;
+			Leaf_			*next;
+			typename std::aligned_storage<sizeof(Value), std::alignment_of<Value>::value>::type	slots[LeafSlots];
+			Value*	values() { return reinterpret_cast<Value*>(slots); }
+		};
+
+		struct Internal_ : public Node_ {
+			typename std::aligned_storage<sizeof(Key), std::alignment_of<Key>::value>::type	slots[InnerSlots];
+			Node_			*children[InnerSlots + 1];
+			Key*	keys() { return reinterpret_cast<Key*>(slots); }
+		};
+
+		typedef std::size_t																size_type;
+		typedef ft::BTreeIterator<Leaf_, Value>											iterator;
+		typedef ft::BTreeIterator<Leaf_, const Value>									const_iterator;
+		typedef typename A::template rebind<Value>::other								allocator_value;
+		typedef typename A::template rebind<Key>::other									allocator_key;
+		typedef typename A::template rebind<Leaf_>::other								allocator_leaf;
+		typedef typename A::template rebind<Internal_>::other							allocator_internal;
+
+	private:
+		allocator_value		_allocator_value;
+		allocator_key		_allocator_key;
+		allocator_leaf		_allocator_leaf;
+		allocator_internal	_allocator_internal;
+		Compare				_comp;
+		KeyOfValue			_key;
+		Node_				*_root;
+		Leaf_				*_first;
+		Leaf_				*_last;
+		size_type			_size;
+
+	public:
+		/**************************** Constructors ****************************/
+		explicit BTree(const Compare& comp = Compare(), const A& alloc = A())
+			: _allocator_value(alloc), _allocator_key(alloc), _allocator_leaf(alloc), _allocator_internal(alloc),
+			_comp(comp), _size(0) {
+			_root = _first = _last = newLeaf();
+		}
+
+		BTree(const BTree& other)
+			: _allocator_value(other._allocator_value), _allocator_key(other._allocator_key),
+			_allocator_leaf(other._allocator_leaf), _allocator_internal(other._allocator_internal),
+			_comp(other._comp), _size(other._size) {
+			Leaf_ *prev = NULL;
+
+			_first = NULL;
+			_root = cloneNode(other._root, NULL, 0, prev);
+			_last = prev;
+		}
+
+		BTree& operator=(const BTree& other) {
+			if (this == &other)
+				return *this;
+			BTree tmp(other);
+			swap(tmp);
+			return *this;
+		}
+
+		~BTree() { destroyNode(_root); }
+
+		/*************************** Members Methods **************************/
+		iterator		begin()			{ return iterator(_first, 0); }
+		const_iterator	begin() const	{ return const_iterator(_first, 0); }
+		iterator		end()			{ return iterator(_last, _last->count); }
+		const_iterator	end() const		{ return const_iterator(_last, _last->count); }
+		size_type		size() const	{ return _size; }
+		Compare			comp() const	{ return _comp; }
+
+		void clear() {
+			destroyNode(_root);
+			_root = _first = _last = newLeaf();
+			_size = 0;
+		}
+
+		void swap(BTree& other) {
+			std::swap(_comp, other._comp);
+			std::swap(_root, other._root);
+			std::swap(_first, other._first);
+			std::swap(_last, other._last);
+			std::swap(_size, other._size);
+		}
+
+		template <class K>
+		iterator lowerBound(const K& key) const {
+			Leaf_ *leaf = descend(key);
+			return normalize(leaf, leafLower(leaf, key));
+		}
+
+		template <class K>
+		iterator upperBound(const K& key) const {
+			Leaf_ *leaf = descend(key);
+			return normalize(leaf, leafUpper(leaf, key));
+		}
+
+		template <class K>
+		iterator find(const K& key) const {
+			Leaf_ *leaf = descend(key);
+			unsigned short i = leafLower(leaf, key);
+
+			if (i == leaf->count || _comp(key, _key(leaf->values()[i])))
+				return iterator(_last, _last->count);
+			return iterator(leaf, i);
+		}
+
+		ft::pair<iterator, bool> insertUnique(const Value& value) {
+			Leaf_ *leaf = descend(_key(value));
+			unsigned short i = leafLower(leaf, _key(value));
+
+			if (i < leaf->count && !_comp(_key(value), _key(leaf->values()[i])))
+				return ft::make_pair(iterator(leaf, i), false);
+			return ft::make_pair(insertAt(leaf, i, value), true);
+		}
+
+		/* Inserts in place when value belongs right before hint inside its leaf,
+		** or after the last element; anything else goes through the root. */
+		iterator insertHint(iterator hint, const Value& value) {
+			Leaf_ *leaf = hint.leaf();
+			unsigned short i = hint.index();
+
+			if ((i == leaf->count || _comp(_key(value), _key(leaf->values()[i])))
+					&& ((i && _comp(_key(leaf->values()[i - 1]), _key(value))) || (!i && !leaf->prev)))
+				return insertAt(leaf, i, value);
+			return insertUnique(value).first;
+		}
+
+		/* Returns the element that followed the erased one. */
+		iterator erase(iterator pos) {
+			Leaf_ *leaf = pos.leaf();
+			unsigned short i = pos.index();
+			Value *values = leaf->values();
+
+			_allocator_value.destroy(values + i);
+			for (unsigned short j = i; j + 1 < leaf->count; ++j)
+				relocate(values + j, values + j + 1);
+			--leaf->count;
+			--_size;
+			if (leaf != _root && leaf->count < LeafMin)
+				rebalanceLeaf(leaf, i);
+			return normalize(leaf, i);
+		}
+
+		/* Erasing rebalances leaves, so last cannot be trusted past the first
+		** erase: the range is counted up front instead. */
+		void erase(iterator first, iterator last) {
+			size_type n = 0;
+
+			if (first == begin() && last == end())
+				return clear();
+			for (iterator it = first; it != last; ++it)
+				++n;
+			for ( ; n; --n)
+				first = erase(first);
+		}
+
+	private:
+		/***************************** Lookup ******************************/
+		template <class K>
+		Leaf_* descend(const K& key) const {
+			Node_ *node = _root;
+
+			while (!node->leaf) {
+				Internal_ *inner = static_cast<Internal_*>(node);
+				node = inner->children[ft::BinarySearch::upper(inner->keys(), inner->count, key, _comp)];
+			}
+			return static_cast<Leaf_*>(node);
+		}
+
+		template <class K>
+		unsigned short leafLower(Leaf_ *leaf, const K& key) const {
+			unsigned short first = 0, n = leaf->count;
+
+			while (n) {
+				unsigned short half = n / 2;
+				if (_comp(_key(leaf->values()[first + half]), key)) {
+					first += half + 1;
+					n -= half + 1;
+				} else {
+					n = half;
+				}
+			}
+			return first;
+		}
+
+		template <class K>
+		unsigned short leafUpper(Leaf_ *leaf, const K& key) const {
+			unsigned short first = 0, n = leaf->count;
+
+			while (n) {
+				unsigned short half = n / 2;
+				if (!_comp(key, _key(leaf->values()[first + half]))) {
+					first += half + 1;
+					n -= half + 1;
+				} else {
+					n = half;
+				}
+			}
+			return first;
+		}
+
+		iterator normalize(Leaf_ *leaf, unsigned short i) const {
+			if (i == leaf->count && leaf->next)
+				return iterator(leaf->next, 0);
+			return iterator(leaf, i);
+		}
+
+		/**************************** Insertion *****************************/
+		iterator insertAt(Leaf_ *leaf, unsigned short i, const Value& value) {
+			if (leaf->count == LeafSlots) {
+				/* Appending past the last leaf leaves it full instead of halving
+				** it, so sequential loads produce packed leaves. */
+				unsigned short mid = (!leaf->next && i == leaf->count) ? leaf->count : leaf->count / 2;
+				Leaf_ *right = newLeaf();
+
+				for (unsigned short j = mid; j < leaf->count; ++j)
+					relocate(right->values() + j - mid, leaf->values() + j);
+				right->count = leaf->count - mid;
+				leaf->count = mid;
+				linkLeaf(leaf, right);
+				if (i >= mid) {
+					leaf = right;
+					i -= mid;
+				}
+				placeValue(leaf, i, value);
+				insertParent(right->prev, _key(right->values()[0]), right);
+				return iterator(leaf, i);
+			}
+			placeValue(leaf, i, value);
+			return iterator(leaf, i);
+		}
+
+		void placeValue(Leaf_ *leaf, unsigned short i, const Value& value) {
+			Value *values = leaf->values();
+
+			for (unsigned short j = leaf->count; j > i; --j)
+				relocate(values + j, values + j - 1);
+			_allocator_value.construct(values + i, value);
+			++leaf->count;
+			++_size;
+		}
+
+		/* Hangs right, with separator key, just after left in left's parent. */
+		void insertParent(Node_ *left, const Key& key, Node_ *right) {
+			Internal_ *parent = left->parent;
+
+			if (!parent) {
+				Internal_ *root = newInternal();
+				_allocator_key.construct(root->keys(), key);
+				root->count = 1;
+				setChild(root, 0, left);
+				setChild(root, 1, right);
+				_root = root;
+				return;
+			}
+			if (parent->count == InnerSlots) {
+				unsigned short mid = InnerSlots / 2;
+				Internal_ *sibling = newInternal();
+				Key up(parent->keys()[mid]);
+
+				for (unsigned short j = mid + 1; j < parent->count; ++j)
+					relocateKey(sibling->keys() + j - mid - 1, parent->keys() + j);
+				for (unsigned short j = mid + 1; j <= parent->count; ++j)
+					setChild(sibling, j - mid - 1, parent->children[j]);
+				_allocator_key.destroy(parent->keys() + mid);
+				sibling->count = parent->count - mid - 1;
+				parent->count = mid;
+				insertParent(parent, up, sibling);
+				parent = left->parent;
+			}
+			unsigned short i = left->position;
+			for (unsigned short j = parent->count; j > i; --j) {
+				relocateKey(parent->keys() + j, parent->keys() + j - 1);
+				setChild(parent, j + 1, parent->children[j]);
+			}
+			_allocator_key.construct(parent->keys() + i, key);
+			setChild(parent, i + 1, right);
+			++parent->count;
+		}
+
+		/***************************** Erasure ******************************/
+		/* Refills an underfull leaf from a sibling or merges it away. i follows
+		** the position of the erased element's successor. */
+		void rebalanceLeaf(Leaf_ *&leaf, unsigned short &i) {
+			Internal_ *parent = leaf->parent;
+			unsigned short pos = leaf->position;
+			Leaf_ *left = pos > 0 ? static_cast<Leaf_*>(parent->children[pos - 1]) : NULL;
+			Leaf_ *right = pos < parent->count ? static_cast<Leaf_*>(parent->children[pos + 1]) : NULL;
+
+			if (left && left->count > LeafMin) {
+				for (unsigned short j = leaf->count; j > 0; --j)
+					relocate(leaf->values() + j, leaf->values() + j - 1);
+				relocate(leaf->values(), left->values() + --left->count);
+				++leaf->count;
+				++i;
+				assignKey(parent->keys() + pos - 1, _key(leaf->values()[0]));
+			} else if (right && right->count > LeafMin) {
+				relocate(leaf->values() + leaf->count++, right->values());
+				for (unsigned short j = 0; j + 1 < right->count; ++j)
+					relocate(right->values() + j, right->values() + j + 1);
+				--right->count;
+				assignKey(parent->keys() + pos, _key(right->values()[0]));
+			} else if (left) {
+				i += left->count;
+				for (unsigned short j = 0; j < leaf->count; ++j)
+					relocate(left->values() + left->count + j, leaf->values() + j);
+				left->count += leaf->count;
+				leaf->count = 0;
+				unlinkLeaf(leaf);
+				removeChild(parent, pos - 1);
+				freeLeaf(leaf);
+				leaf = left;
+				rebalanceInternal(parent);
+			} else if (right) {
+				for (unsigned short j = 0; j < right->count; ++j)
+					relocate(leaf->values() + leaf->count + j, right->values() + j);
+				leaf->count += right->count;
+				right->count = 0;
+				unlinkLeaf(right);
+				removeChild(parent, pos);
+				freeLeaf(right);
+				rebalanceInternal(parent);
+			}
+		}
+
+		void rebalanceInternal(Internal_ *node) {
+			if (node == _root) {
+				if (!node->count) {
+					_root = node->children[0];
+					_root->parent = NULL;
+					_root->position = 0;
+					freeInternal(node);
+				}
+				return;
+			}
+			if (node->count >= InnerMin)
+				return;
+
+			Internal_ *parent = node->parent;
+			unsigned short pos = node->position;
+			Internal_ *left = pos > 0 ? static_cast<Internal_*>(parent->children[pos - 1]) : NULL;
+			Internal_ *right = pos < parent->count ? static_cast<Internal_*>(parent->children[pos + 1]) : NULL;
+
+			if (left && left->count > InnerMin) {
+				for (unsigned short j = node->count; j > 0; --j)
+					relocateKey(node->keys() + j, node->keys() + j - 1);
+				for (unsigned short j = node->count + 1; j > 0; --j)
+					setChild(node, j, node->children[j - 1]);
+				relocateKey(node->keys(), parent->keys() + pos - 1);
+				setChild(node, 0, left->children[left->count]);
+				relocateKey(parent->keys() + pos - 1, left->keys() + left->count - 1);
+				--left->count;
+				++node->count;
+			} else if (right && right->count > InnerMin) {
+				relocateKey(node->keys() + node->count, parent->keys() + pos);
+				setChild(node, node->count + 1, right->children[0]);
+				++node->count;
+				relocateKey(parent->keys() + pos, right->keys());
+				for (unsigned short j = 0; j + 1 < right->count; ++j)
+					relocateKey(right->keys() + j, right->keys() + j + 1);
+				for (unsigned short j = 0; j < right->count; ++j)
+					setChild(right, j, right->children[j + 1]);
+				--right->count;
+			} else if (left) {
+				mergeInternal(left, parent, pos - 1, node);
+			} else if (right) {
+				mergeInternal(node, parent, pos, right);
+			}
+		}
+
+		/* Pulls separator parent->keys[i] and all of right into left. */
+		void mergeInternal(Internal_ *left, Internal_ *parent, unsigned short i, Internal_ *right) {
+			relocateKey(left->keys() + left->count, parent->keys() + i);
+			for (unsigned short j = 0; j < right->count; ++j)
+				relocateKey(left->keys() + left->count + 1 + j, right->keys() + j);
+			for (unsigned short j = 0; j <= right->count; ++j)
+				setChild(left, left->count + 1 + j, right->children[j]);
+			left->count += right->count + 1;
+			right->count = 0;
+			for (unsigned short j = i; j + 1 < parent->count; ++j) {
+				relocateKey(parent->keys() + j, parent->keys() + j + 1);
+				setChild(parent, j + 1, parent->children[j + 2]);
+			}
+			--parent->count;
+			freeInternal(right);
+			rebalanceInternal(parent);
+		}
+
+		/* Drops separator i and child i + 1 from node. */
+		void removeChild(Internal_ *node, unsigned short i) {
+			_allocator_key.destroy(node->keys() + i);
+			for (unsigned short j = i; j + 1 < node->count; ++j) {
+				relocateKey(node->keys() + j, node->keys() + j + 1);
+				setChild(node, j + 1, node->children[j + 2]);
+			}
+			--node->count;
+		}
+
+		/**************************** Node helpers ****************************/
+		/* Moves a value to an empty slot, copying only when its move may throw. */
+		void relocate(Value *dst, Value *src) {
+			_allocator_value.construct(dst, std::move_if_noexcept(*src));
+			_allocator_value.destroy(src);
+		}
+
+		void relocateKey(Key *dst, Key *src) {
+			_allocator_key.construct(dst, std::move_if_noexcept(*src));
+			_allocator_key.destroy(src);
+		}
+
+		void assignKey(Key *dst, const Key& key) {
+			_allocator_key.destroy(dst);
+			_allocator_key.construct(dst, key);
+		}
+
+		void setChild(Internal_ *node, unsigned short i, Node_ *child) {
+			node->children[i] = child;
+			child->parent = node;
+			child->position = i;
+		}
+
+		void linkLeaf(Leaf_ *leaf, Leaf_ *right) {
+			right->prev = leaf;
+			right->next = leaf->next;
+			if (leaf->next)
+				leaf->next->prev = right;
+			else
+				_last = right;
+			leaf->next = right;
+		}
+
+		void unlinkLeaf(Leaf_ *leaf) {
+			if (leaf->prev)
+				leaf->prev->next = leaf->next;
+			else
+				_first = leaf->next;
+			if (leaf->next)
+				leaf->next->prev = leaf->prev;
+			else
+				_last = leaf->prev;
+		}
+
+		Leaf_* newLeaf() {
+			Leaf_ *leaf = _allocator_leaf.allocate(1);
+
+			leaf->parent = NULL;
+			leaf->position = 0;
+			leaf->count = 0;
+			leaf->leaf = true;
+			leaf->prev = leaf->next = NULL;
+			return leaf;
+		}
+
+		Internal_* newInternal() {
+			Internal_ *node = _allocator_internal.allocate(1);
+
+			node->parent = NULL;
+			node->position = 0;
+			node->count = 0;
+			node->leaf = false;
+			return node;
+		}
+
+		void freeLeaf(Leaf_ *leaf)				{ _allocator_leaf.deallocate(leaf, 1); }
+		void freeInternal(Internal_ *node)		{ _allocator_internal.deallocate(node, 1); }
+
+		void destroyNode(Node_ *node) {
+			if (node->leaf) {
+				Leaf_ *leaf = static_cast<Leaf_*>(node);
+				for (unsigned short j = 0; j < leaf->count; ++j)
+					_allocator_value.destroy(leaf->values() + j);
+				freeLeaf(leaf);
+				return;
+			}
+			Internal_ *inner = static_cast<Internal_*>(node);
+			for (unsigned short j = 0; j <= inner->count; ++j)
+				destroyNode(inner->children[j]);
+			for (unsigned short j = 0; j < inner->count; ++j)
+				_allocator_key.destroy(inner->keys() + j);
+			freeInternal(inner);
+		}
+
+		/* Copies the subtree under src; prev tracks the last leaf cloned so far
+		** so the new leaves come out chained in order. */
+		Node_* cloneNode(Node_ *src, Internal_ *parent, unsigned short position, Leaf_ *&prev) {
+			if (src->leaf) {
+				Leaf_ *from = static_cast<Leaf_*>(src), *leaf = newLeaf();
+				for (unsigned short j = 0; j < from->count; ++j)
+					_allocator_value.construct(leaf->values() + j, from->values()[j]);
+				leaf->count = from->count;
+				leaf->parent = parent;
+				leaf->position = position;
+				leaf->prev = prev;
+				if (prev)
+					prev->next = leaf;
+				else
+					_first = leaf;
+				prev = leaf;
+				return leaf;
+			}
+			Internal_ *from = static_cast<Internal_*>(src), *node = newInternal();
+			for (unsigned short j = 0; j < from->count; ++j)
+				_allocator_key.construct(node->keys() + j, from->keys()[j]);
+			node->count = from->count;
+			node->parent = parent;
+			node->position = position;
+			for (unsigned short j = 0; j <= from->count; ++j)
+				node->children[j] = cloneNode(from->children[j], node, j, prev);
+			return node;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,488 @@
+#pragma once
+#ifndef CONCURRENT_MAP_HPP
+#define CONCURRENT_MAP_HPP
+
+# include <atomic>
+# include <cstdint>
+# include <functional>
+# include <limits>
+# include <memory>
+# include <new>
+# include <stdexcept>
+# include <thread>
+# include <type_traits>
+# include <utility>
+# include "Epoch.hpp"
+# include "Iterator.hpp"
+# include "Utility.hpp"
+
+namespace ft {
+	/*
+	** Ordered map shared by many threads: a lazy skip list after Herlihy, Lev,
+	** Luchangco and Shavit. Lookups and iteration take no locks and never
+	** wait; insert and erase lock only the nodes next to the one they change.
+	** Erased nodes are freed through an ft::EpochDomain once no thread can
+	** reach them, and an iterator keeps its thread pinned, so it stays valid
+	** across concurrent erases. Iteration is weakly consistent: it sees the
+	** keys present throughout and may or may not see those inserted or erased
+	** meanwhile. Mapped values are not synchronised: writing one while other
+	** threads read it is up to the caller. Copies, clear() and the destructor
+	** need the map to themselves.
+	*/
+	template <class Key, class T, class Compare = std::less<Key>, class A = std::allocator<ft::pair<const Key, T> > >
+	class ConcurrentMap {
+	public:
+		typedef Key																	key_type;
+		typedef T																	mapped_type;
+		typedef ft::pair<const Key, T>												value_type;
+		typedef std::size_t															size_type;
+		typedef std::ptrdiff_t														difference_type;
+		typedef Compare																key_compare;
+		typedef A																	allocator_type;
+		typedef value_type&															reference;
+		typedef const value_type&													const_reference;
+
+	private:
+		static const int	_max_height = 32;
+
+		/* The tower of next pointers sits right behind the node, sized to its
+		** height. The head has the full height and no value. */
+		struct Node_ {
+			std::atomic<Node_*>		*next;
+			int						height;
+			std::atomic<bool>		marked;
+			std::atomic<bool>		linked;
+			std::atomic_flag		latch;
+			typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type	storage;
+
+			value_type&	value()			{ return *reinterpret_cast<value_type*>(&storage); }
+			const Key&	key()			{ return value().first; }
+			bool		live() const	{ return linked.load(std::memory_order_acquire) && !marked.load(std::memory_order_acquire); }
+
+			void lock() {
+				for (unsigned spins = 0; latch.test_and_set(std::memory_order_acquire); )
+					if (++spins % 64 == 0)
+						std::this_thread::yield();
+			}
+			void unlock() { latch.clear(std::memory_order_release); }
+
+			static Node_* nextLive(Node_ *x) {
+				do {
+					x = x->next[0].load(std::memory_order_acquire);
+				} while (x && !x->live());
+				return x;
+			}
+		};
+
+	public:
+		typedef ft::SkipIterator<Node_, value_type, EpochDomain::Guard>			iterator;
+		typedef ft::SkipIterator<Node_, const value_type, EpochDomain::Guard>	const_iterator;
+		typedef typename allocator_type::template rebind<char>::other			allocator_bytes;
+
+	private:
+		allocator_type					_allocator;
+		allocator_bytes					_allocator_bytes;
+		Compare							_comp;
+		Node_							*_head;
+		std::atomic<size_type>			_size;
+		mutable EpochDomain				_epoch;
+
+	public:
+		/**************************** Constructors ****************************/
+		explicit ConcurrentMap(const Compare& comp = Compare(), const A& alloc = A())
+			: _allocator(alloc), _allocator_bytes(alloc), _comp(comp), _head(newNode(_max_height)), _size(0), _epoch(releaseNode, this) {}
+
+		template <class InputIt>
+		ConcurrentMap(InputIt first, InputIt last, const Compare& comp = Compare(), const A& alloc = A())
+			: _allocator(alloc), _allocator_bytes(alloc), _comp(comp), _head(newNode(_max_height)), _size(0), _epoch(releaseNode, this) {
+			insert(first, last);
+		}
+
+		ConcurrentMap(const ConcurrentMap& other)
+			: _allocator(other._allocator), _allocator_bytes(other._allocator_bytes), _comp(other._comp),
+			_head(newNode(_max_height)), _size(0), _epoch(releaseNode, this) {
+			appendAll(other);
+		}
+
+		ConcurrentMap& operator=(const ConcurrentMap& other) {
+			if (this == &other)
+				return *this;
+			clear();
+			_comp = other._comp;
+			appendAll(other);
+			return *this;
+		}
+
+		~ConcurrentMap() {
+			clear();
+			freeNode(_head);
+		}
+
+		/*************************** Members Methods **************************/
+		allocator_type		get_allocator() const	{ return _allocator; }
+		key_compare			key_comp() const		{ return _comp; }
+		bool				empty() const			{ return size() == 0; }
+		size_type			size() const			{ return _size.load(std::memory_order_relaxed); }
+		size_type			max_size() const		{ return std::numeric_limits<difference_type>::max() / sizeof(Node_); }
+
+		iterator			begin()					{ EpochDomain::Guard g(_epoch); return iterator(Node_::nextLive(_head), g); }
+		const_iterator		begin() const			{ EpochDomain::Guard g(_epoch); return const_iterator(Node_::nextLive(_head), g); }
+		iterator			end()					{ return iterator(); }
+		const_iterator		end() const				{ return const_iterator(); }
+
+		void clear() {
+			for (Node_ *x = _head->next[0].load(std::memory_order_relaxed); x; ) {
+				Node_ *next = x->next[0].load(std::memory_order_relaxed);
+				destroyNode(x);
+				x = next;
+			}
+			for (int level = 0; level < _max_height; ++level)
+				_head->next[level].store(NULL, std::memory_order_relaxed);
+			_size.store(0, std::memory_order_relaxed);
+		}
+
+		ft::pair<iterator, bool> insert( const value_type& value )	{ return emplaceKey(value.first, value); }
+		ft::pair<iterator, bool> insert( value_type&& value )		{ return emplaceKey(value.first, std::move(value)); }
+
+		template <class InputIt>
+		void insert( InputIt first, InputIt last ) {
+			for ( ; first != last; ++first)
+				emplaceKey(first->first, first->first, first->second);
+		}
+
+		/* The key is needed before anything can be linked, so emplace builds
+		** the value up front; try_emplace looks the key up first and only
+		** builds the value when it was missing. */
+		template <class... Args>
+		ft::pair<iterator, bool> emplace( Args&&... args ) {
+			value_type value(std::forward<Args>(args)...);
+
+			return emplaceKey(value.first, std::move(value));
+		}
+
+		template <class... Args>
+		ft::pair<iterator, bool> try_emplace( const Key& key, Args&&... args ) {
+			iterator pos = find(key);
+
+			if (pos != end())
+				return ft::pair<iterator, bool>(pos, false);
+			return emplaceKey(key, key, T(std::forward<Args>(args)...));
+		}
+
+		size_type	erase( const Key& key )				{ return eraseKey(key); }
+		void		erase( iterator pos )				{ eraseKey(pos->first); }
+
+		iterator			find( const Key& key )					{ return findNode<iterator>(key); }
+		const_iterator		find( const Key& key ) const			{ return findNode<const_iterator>(key); }
+		size_type			count( const Key& key ) const			{ return find(key) == end() ? 0 : 1; }
+		iterator			lower_bound( const Key& key )			{ return boundNode<iterator>(key, false); }
+		const_iterator		lower_bound( const Key& key ) const		{ return boundNode<const_iterator>(key, false); }
+		iterator			upper_bound( const Key& key )			{ return boundNode<iterator>(key, true); }
+		const_iterator		upper_bound( const Key& key ) const		{ return boundNode<const_iterator>(key, true); }
+
+		ft::pair<iterator, iterator> equal_range( const Key& key ) {
+			return ft::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+		}
+
+		ft::pair<const_iterator, const_iterator> equal_range( const Key& key ) const {
+			return ft::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+		}
+
+		/* A copy, not a reference: nothing would keep the node alive once
+		** another thread erased it. */
+		mapped_type			at( const Key& key ) const				{ return valueAt(key); }
+
+		/* With a transparent Compare the lookups take anything it can compare
+		** against a Key. */
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		find( const K& key )					{ return findNode<iterator>(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, const_iterator>::type
+		find( const K& key ) const				{ return findNode<const_iterator>(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, size_type>::type
+		count( const K& key ) const				{ return find(key) == end() ? 0 : 1; }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		lower_bound( const K& key )				{ return boundNode<iterator>(key, false); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, const_iterator>::type
+		lower_bound( const K& key ) const		{ return boundNode<const_iterator>(key, false); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		upper_bound( const K& key )				{ return boundNode<iterator>(key, true); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, const_iterator>::type
+		upper_bound( const K& key ) const		{ return boundNode<const_iterator>(key, true); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, ft::pair<iterator, iterator> >::type
+		equal_range( const K& key ) {
+			return ft::pair<iterator, iterator>(boundNode<iterator>(key, false), boundNode<iterator>(key, true));
+		}
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, ft::pair<const_iterator, const_iterator> >::type
+		equal_range( const K& key ) const {
+			return ft::pair<const_iterator, const_iterator>(boundNode<const_iterator>(key, false), boundNode<const_iterator>(key, true));
+		}
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, mapped_type>::type
+		at( const K& key ) const				{ return valueAt(key); }
+
+	private:
+		static std::size_t nodeBytes(int height) { return sizeof(Node_) + height * sizeof(std::atomic<Node_*>); }
+
+		static void releaseNode(void *context, void *node) {
+			static_cast<ConcurrentMap*>(context)->destroyNode(static_cast<Node_*>(node));
+		}
+
+		Node_* newNode(int height) {
+			Node_ *x = reinterpret_cast<Node_*>(_allocator_bytes.allocate(nodeBytes(height)));
+
+			new (x) Node_();
+			x->next = reinterpret_cast<std::atomic<Node_*>*>(reinterpret_cast<char*>(x) + sizeof(Node_));
+			for (int level = 0; level < height; ++level)
+				new (x->next + level) std::atomic<Node_*>(NULL);
+			x->height = height;
+			x->marked.store(false, std::memory_order_relaxed);
+			x->linked.store(false, std::memory_order_relaxed);
+			x->latch.clear(std::memory_order_relaxed);
+			return x;
+		}
+
+		void freeNode(Node_ *x) {
+			std::size_t bytes = nodeBytes(x->height);
+
+			x->~Node_();
+			_allocator_bytes.deallocate(reinterpret_cast<char*>(x), bytes);
+		}
+
+		template <class... Args>
+		Node_* createNode(int height, Args&&... args) {
+			Node_ *x = newNode(height);
+
+			try {
+				new (&x->storage) value_type(std::forward<Args>(args)...);
+			} catch (...) {
+				freeNode(x);
+				throw;
+			}
+			return x;
+		}
+
+		void destroyNode(Node_ *x) {
+			x->value().~value_type();
+			freeNode(x);
+		}
+
+		/* Tower heights follow a geometric law with p = 1/2, from a per-thread
+		** xorshift generator. */
+		static int randomHeight() {
+			static thread_local std::uint64_t	state = 0;
+			std::uint64_t						bits;
+			int									height = 1;
+
+			if (!state)
+				state = reinterpret_cast<std::uintptr_t>(&state) | 1;
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			bits = state * 0x2545F4914F6CDD1DULL;
+			for ( ; height < _max_height && (bits & 1); bits >>= 1)
+				++height;
+			return height;
+		}
+
+		/* Fills preds and succs with the nodes around key on every level and
+		** returns the highest level holding key, or -1. */
+		template <class K>
+		int locate(const K& key, Node_ **preds, Node_ **succs) const {
+			Node_	*pred = _head, *curr;
+			int		found = -1;
+
+			for (int level = _max_height - 1; level >= 0; --level) {
+				curr = pred->next[level].load(std::memory_order_acquire);
+				while (curr && _comp(curr->key(), key)) {
+					pred = curr;
+					curr = pred->next[level].load(std::memory_order_acquire);
+				}
+				if (found == -1 && curr && !_comp(key, curr->key()))
+					found = level;
+				preds[level] = pred;
+				succs[level] = curr;
+			}
+			return found;
+		}
+
+		/* First live node not less than key, or greater than it with upper. */
+		template <class K>
+		Node_* bound(const K& key, bool upper) const {
+			Node_ *pred = _head, *curr = NULL;
+
+			for (int level = _max_height - 1; level >= 0; --level) {
+				curr = pred->next[level].load(std::memory_order_acquire);
+				while (curr && (upper ? !_comp(key, curr->key()) : _comp(curr->key(), key))) {
+					pred = curr;
+					curr = pred->next[level].load(std::memory_order_acquire);
+				}
+			}
+			return (curr && !curr->live()) ? Node_::nextLive(curr) : curr;
+		}
+
+		template <class It, class K>
+		It boundNode(const K& key, bool upper) const {
+			EpochDomain::Guard guard(_epoch);
+
+			return It(bound(key, upper), guard);
+		}
+
+		template <class K>
+		mapped_type valueAt(const K& key) const {
+			EpochDomain::Guard guard(_epoch);
+			Node_ *x = bound(key, false);
+
+			if (!x || _comp(key, x->key()))
+				throw std::out_of_range("ft::ConcurrentMap: key not found");
+			return x->value().second;
+		}
+
+		template <class It, class K>
+		It findNode(const K& key) const {
+			EpochDomain::Guard guard(_epoch);
+			Node_ *x = bound(key, false);
+
+			return (x && !_comp(key, x->key())) ? It(x, guard) : It();
+		}
+
+		static void unlockPreds(Node_ **preds, int highest) {
+			for (int level = 0; level <= highest; ++level)
+				if (!level || preds[level] != preds[level - 1])
+					preds[level]->unlock();
+		}
+
+		/* Locks the distinct predecessors on levels [0, height) bottom up and
+		** checks that nothing changed around them since locate(); highest
+		** gets the last level locked. */
+		static bool lockPreds(Node_ **preds, Node_ **succs, int height, int &highest, bool erasing) {
+			bool valid = true;
+
+			highest = -1;
+			for (int level = 0; valid && level < height; ++level) {
+				Node_ *pred = preds[level], *succ = succs[level];
+				if (!level || pred != preds[level - 1])
+					pred->lock();
+				highest = level;
+				valid = !pred->marked.load(std::memory_order_acquire)
+					&& pred->next[level].load(std::memory_order_acquire) == succ
+					&& (erasing || !succ || !succ->marked.load(std::memory_order_acquire));
+			}
+			return valid;
+		}
+
+		/* A key being erased is waited out; one being inserted is waited for. */
+		template <class K, class... Args>
+		ft::pair<iterator, bool> emplaceKey(const K& key, Args&&... args) {
+			EpochDomain::Guard	guard(_epoch);
+			Node_				*preds[_max_height], *succs[_max_height], *x;
+			int					height = randomHeight(), found, highest;
+
+			for (;;) {
+				if ((found = locate(key, preds, succs)) != -1) {
+					x = succs[found];
+					if (x->marked.load(std::memory_order_acquire))
+						continue;
+					while (!x->linked.load(std::memory_order_acquire))
+						std::this_thread::yield();
+					return ft::pair<iterator, bool>(iterator(x, guard), false);
+				}
+				if (!lockPreds(preds, succs, height, highest, false)) {
+					unlockPreds(preds, highest);
+					continue;
+				}
+				try {
+					x = createNode(height, std::forward<Args>(args)...);
+				} catch (...) {
+					unlockPreds(preds, highest);
+					throw;
+				}
+				for (int level = 0; level < height; ++level)
+					x->next[level].store(succs[level], std::memory_order_relaxed);
+				for (int level = 0; level < height; ++level)
+					preds[level]->next[level].store(x, std::memory_order_release);
+				x->linked.store(true, std::memory_order_release);
+				unlockPreds(preds, highest);
+				_size.fetch_add(1, std::memory_order_relaxed);
+				return ft::pair<iterator, bool>(iterator(x, guard), true);
+			}
+		}
+
+		/* Marking the victim under its lock erases it; unlinking it from every
+		** level under its predecessors' locks follows, then it is retired. */
+		template <class K>
+		size_type eraseKey(const K& key) {
+			EpochDomain::Guard	guard(_epoch);
+			Node_				*preds[_max_height], *succs[_max_height], *victim = NULL;
+			int					found, highest;
+
+			for (;;) {
+				found = locate(key, preds, succs);
+				if (!victim) {
+					if (found == -1)
+						return 0;
+					victim = succs[found];
+					if (!victim->linked.load(std::memory_order_acquire) || victim->height - 1 != found
+							|| victim->marked.load(std::memory_order_acquire))
+						return 0;
+					victim->lock();
+					if (victim->marked.load(std::memory_order_relaxed)) {
+						victim->unlock();
+						return 0;
+					}
+					victim->marked.store(true, std::memory_order_release);
+				}
+				for (int level = 0; level < victim->height; ++level)
+					succs[level] = victim;
+				if (!lockPreds(preds, succs, victim->height, highest, true)) {
+					unlockPreds(preds, highest);
+					continue;
+				}
+				for (int level = victim->height - 1; level >= 0; --level)
+					preds[level]->next[level].store(victim->next[level].load(std::memory_order_relaxed), std::memory_order_release);
+				victim->unlock();
+				unlockPreds(preds, highest);
+				_size.fetch_sub(1, std::memory_order_relaxed);
+				_epoch.retire(victim);
+				return 1;
+			}
+		}
+
+		/* Copies other in order into this empty map, appending every tower to
+		** the last one of each level. */
+		void appendAll(const ConcurrentMap& other) {
+			Node_ *tails[_max_height];
+
+			for (int level = 0; level < _max_height; ++level)
+				tails[level] = _head;
+			for (const_iterator it = other.begin(); it != other.end(); ++it) {
+				Node_ *x = createNode(randomHeight(), *it);
+				for (int level = 0; level < x->height; ++level) {
+					tails[level]->next[level].store(x, std::memory_order_relaxed);
+					tails[level] = x;
+				}
+				x->linked.store(true, std::memory_order_release);
+				_size.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,225 @@
+#pragma once
+#ifndef CONCURRENT_STACK_HPP
+#define CONCURRENT_STACK_HPP
+
+# include <atomic>
+# include <cstddef>
+# include <cstdint>
+# include <limits>
+# include <memory>
+# include <new>
+# include <thread>
+# include <type_traits>
+# include <utility>
+
+namespace ft {
+	/*
+	** Lock-free stack for many producers and consumers: a Treiber stack.
+	** Nodes live in slabs owned by the stack and are recycled through a
+	** second Treiber stack rather than freed, so a thread reading a node
+	** that was popped under it still reads valid memory. Both heads pack a
+	** 32-bit node index with a 32-bit tag bumped by every change, which
+	** stops a stale compare-and-swap from succeeding when a node left and
+	** came back meanwhile (ABA), short of 2^32 changes within it.
+	** A failed compare-and-swap backs off before trying again. Memory goes
+	** back to the allocator only with the stack.
+	*/
+	template <class T, class A = std::allocator<T> >
+	class ConcurrentStack {
+	public:
+		typedef T						value_type;
+		typedef std::size_t				size_type;
+		typedef A						allocator_type;
+		typedef value_type&				reference;
+		typedef const value_type&		const_reference;
+
+	private:
+		/* next holds the index of the node below, plus one; 0 ends the list. */
+		struct Node_ {
+			std::atomic<std::uint32_t>	next;
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type	storage;
+
+			Node_(): next(0) {}
+			T&	value()	{ return *reinterpret_cast<T*>(&storage); }
+		};
+
+		typedef typename allocator_type::template rebind<Node_>::other	allocator_rebind_node;
+
+		/* Slab k holds _slab_base << k nodes, so 32 of them cover every index. */
+		static const std::uint32_t	_slab_base = 64;
+		static const int			_slab_count = 32;
+
+		allocator_rebind_node		_allocator_rebind_node;
+		std::atomic<std::uint64_t>	_top;
+		std::atomic<std::uint64_t>	_free;
+		std::atomic<std::uint32_t>	_bump;
+		std::atomic<Node_*>			_slabs[_slab_count];
+
+		ConcurrentStack(const ConcurrentStack& other);
+		ConcurrentStack& operator=(const ConcurrentStack& other);
+
+	public:
+		/**************************** Constructors ****************************/
+		explicit ConcurrentStack(const A& alloc = A())
+			: _allocator_rebind_node(alloc), _top(0), _free(0), _bump(0) {
+			for (int k = 0; k < _slab_count; ++k)
+				_slabs[k].store(NULL, std::memory_order_relaxed);
+		}
+
+		/* No other thread may still use the stack. */
+		~ConcurrentStack() {
+			for (std::uint32_t i = index(_top.load(std::memory_order_acquire)); i; ) {
+				Node_ *x = node(i);
+				i = x->next.load(std::memory_order_relaxed);
+				x->value().~T();
+			}
+			for (int k = 0; k < _slab_count; ++k) {
+				Node_ *slab = _slabs[k].load(std::memory_order_relaxed);
+				if (!slab) continue;
+				for (std::uint32_t j = 0; j < (_slab_base << k); ++j)
+					slab[j].~Node_();
+				_allocator_rebind_node.deallocate(slab, _slab_base << k);
+			}
+		}
+
+		/*************************** Members Methods **************************/
+		allocator_type	get_allocator() const	{ return allocator_type(_allocator_rebind_node); }
+
+		/* A hint only, as other threads may push or pop right after. */
+		bool			empty() const			{ return index(_top.load(std::memory_order_acquire)) == 0; }
+
+		void push( const value_type& value )	{ emplace(value); }
+		void push( value_type&& value )			{ emplace(std::move(value)); }
+
+		template <class... Args>
+		void emplace( Args&&... args ) {
+			std::uint32_t i = acquireNode();
+
+			try {
+				new (&node(i)->storage) T(std::forward<Args>(args)...);
+			} catch (...) {
+				pushIndex(_free, i);
+				throw;
+			}
+			pushIndex(_top, i);
+		}
+
+		/* Moves the top element into value and pops it; false when empty. */
+		bool try_pop( value_type& value ) {
+			std::uint32_t i = popIndex(_top);
+
+			if (!i)
+				return false;
+			Node_ *x = node(i);
+			value = std::move(x->value());
+			x->value().~T();
+			pushIndex(_free, i);
+			return true;
+		}
+
+	private:
+		static std::uint32_t index(std::uint64_t head)	{ return static_cast<std::uint32_t>(head); }
+		static std::uint32_t tag(std::uint64_t head)	{ return static_cast<std::uint32_t>(head >> 32); }
+		static std::uint64_t pack(std::uint32_t tag, std::uint32_t i) { return (static_cast<std::uint64_t>(tag) << 32) | i; }
+
+		/* Spins a little longer after each failed attempt and lets other
+		** threads run once spinning gets long, so that contending threads
+		** spread out instead of failing in lockstep. */
+		struct Backoff_ {
+			unsigned	spins;
+			Backoff_(): spins(1) {}
+
+			void operator()() {
+				if (spins > 1024) {
+					std::this_thread::yield();
+					return;
+				}
+				for (unsigned n = 0; n < spins; ++n)
+					std::atomic_signal_fence(std::memory_order_seq_cst);
+				spins <<= 1;
+			}
+		};
+
+		static int floorLog2(std::uint32_t v) {
+			int r = 0;
+
+			if (v >> 16) { v >>= 16; r += 16; }
+			if (v >> 8) { v >>= 8; r += 8; }
+			if (v >> 4) { v >>= 4; r += 4; }
+			if (v >> 2) { v >>= 2; r += 2; }
+			return r + static_cast<int>(v >> 1);
+		}
+
+		/* Index i, counted from one, sits in slab k = log2((i - 1) / base + 1),
+		** whose first index is base * (2^k - 1) + 1. */
+		Node_* node(std::uint32_t i) const {
+			std::uint32_t	n = i - 1;
+			int				k = floorLog2(n / _slab_base + 1);
+
+			return _slabs[k].load(std::memory_order_acquire) + (n - _slab_base * ((1u << k) - 1));
+		}
+
+		/* A recycled node if there is one, else the next never used index,
+		** whose slab the first thread to need it allocates. */
+		std::uint32_t acquireNode() {
+			std::uint32_t	i = popIndex(_free);
+			std::uint32_t	n;
+			int				k;
+			Node_			*slab, *expected = NULL;
+
+			if (i)
+				return i;
+			n = _bump.fetch_add(1, std::memory_order_relaxed);
+			if (n == std::numeric_limits<std::uint32_t>::max()) {
+				_bump.fetch_sub(1, std::memory_order_relaxed);
+				throw std::bad_alloc();
+			}
+			k = floorLog2(n / _slab_base + 1);
+			if (!_slabs[k].load(std::memory_order_acquire)) {
+				slab = _allocator_rebind_node.allocate(_slab_base << k);
+				for (std::uint32_t j = 0; j < (_slab_base << k); ++j)
+					new (slab + j) Node_();
+				if (!_slabs[k].compare_exchange_strong(expected, slab, std::memory_order_acq_rel)) {
+					for (std::uint32_t j = 0; j < (_slab_base << k); ++j)
+						slab[j].~Node_();
+					_allocator_rebind_node.deallocate(slab, _slab_base << k);
+				}
+			}
+			return n + 1;
+		}
+
+		/* The release on success publishes the node's value and next link to
+		** whoever pops it. */
+		void pushIndex(std::atomic<std::uint64_t>& head, std::uint32_t i) {
+			Node_			*x = node(i);
+			std::uint64_t	old = head.load(std::memory_order_relaxed);
+			Backoff_		backoff;
+
+			for (;;) {
+				x->next.store(index(old), std::memory_order_relaxed);
+				if (head.compare_exchange_weak(old, pack(tag(old) + 1, i), std::memory_order_release, std::memory_order_relaxed))
+					return;
+				backoff();
+			}
+		}
+
+		/* next may be read from a node another thread has just popped and
+		** is reusing; the tag then makes the compare-and-swap fail. */
+		std::uint32_t popIndex(std::atomic<std::uint64_t>& head) {
+			std::uint64_t	old = head.load(std::memory_order_acquire);
+			Backoff_		backoff;
+
+			for (;;) {
+				std::uint32_t i = index(old);
+				if (!i)
+					return 0;
+				std::uint32_t next = node(i)->next.load(std::memory_order_relaxed);
+				if (head.compare_exchange_weak(old, pack(tag(old) + 1, next), std::memory_order_acquire, std::memory_order_acquire))
+					return i;
+				backoff();
+			}
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,232 @@
+#pragma once
+#ifndef EPOCH_HPP
+#define EPOCH_HPP
+
+# include <atomic>
+# include <cstddef>
+# include "Vector.hpp"
+
+namespace ft {
+	/*
+	** Epoch-based reclamation for the concurrent containers. A thread pins
+	** the global epoch while it may hold pointers into the structure, and
+	** memory unlinked from it is retired with the epoch it left in. The epoch
+	** only moves on once every pinned thread has seen the current one, so
+	** memory retired two epochs back can no longer be reached and is handed
+	** to the release callback.
+	*/
+	class EpochDomain {
+		struct Retired_ { void *ptr; unsigned long long epoch; };
+
+		/* One per thread using the domain, never unlinked before the domain
+		** goes. state holds the pinned epoch shifted left, with the low bit
+		** set while pinned. A thread gives its record up when it exits and
+		** the next new thread takes it over, retired list and all; taken is
+		** also held briefly by collect() draining an abandoned record. refs
+		** counts the domain and the owning thread, whichever lets go last
+		** deletes it. */
+		struct Record_ {
+			std::atomic<unsigned long long>	state;
+			std::atomic<bool>				taken;
+			std::atomic<unsigned>			refs;
+			Record_							*next;
+			unsigned						depth;
+			ft::Vector<Retired_>			retired;
+
+			Record_(): state(0), taken(true), refs(2), next(0), depth(0) {}
+
+			void drop() {
+				if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					delete this;
+			}
+		};
+
+		/* The records a thread holds, one per domain id; handed back when
+		** the thread exits. */
+		struct Held_ {
+			struct Entry_ { unsigned long long id; Record_ *record; };
+			ft::Vector<Entry_>	entries;
+
+			~Held_() {
+				for (std::size_t i = 0; i < entries.size(); ++i) {
+					entries[i].record->taken.store(false, std::memory_order_release);
+					entries[i].record->drop();
+				}
+			}
+		};
+
+		static const std::size_t			_collect_every = 64;
+
+		std::atomic<unsigned long long>		_epoch;
+		std::atomic<Record_*>				_records;
+		unsigned long long					_id;
+		void								(*_release)(void *context, void *ptr);
+		void								*_context;
+
+		EpochDomain(const EpochDomain& other);
+		EpochDomain& operator=(const EpochDomain& other);
+
+	public:
+		/* Keeps the calling thread pinned for as long as it lives; guards nest.
+		** A copy pins the copying thread, so an iterator may be copied over to
+		** another thread; each guard has to be released on the thread that
+		** made it. */
+		class Guard {
+			EpochDomain	*_domain;
+			Record_		*_record;
+		public:
+			Guard(): _domain(0), _record(0) {}
+			explicit Guard(EpochDomain& domain): _domain(&domain), _record(domain.local()) { _domain->pin(_record); }
+			Guard(const Guard& other): _domain(other._domain), _record(other._domain ? other._domain->local() : 0) {
+				if (_record) _domain->pin(_record);
+			}
+			~Guard() { if (_record) _domain->unpin(_record); }
+
+			Guard& operator=(const Guard& other) {
+				Record_ *record = other._domain ? other._domain->local() : 0;
+
+				if (record) other._domain->pin(record);
+				if (_record) _domain->unpin(_record);
+				_domain = other._domain;
+				_record = record;
+				return *this;
+			}
+		};
+
+		/**************************** Constructors ****************************/
+		EpochDomain(void (*release)(void *context, void *ptr), void *context)
+			: _epoch(0), _records(0), _id(nextId()), _release(release), _context(context) {}
+
+		/* No thread may still use the domain: whatever is retired goes now.
+		** Records of threads still running stay with them until they exit. */
+		~EpochDomain() {
+			for (Record_ *r = _records.load(std::memory_order_acquire); r; ) {
+				Record_ *next = r->next;
+				for (std::size_t i = 0; i < r->retired.size(); ++i)
+					_release(_context, r->retired[i].ptr);
+				r->retired.clear();
+				r->drop();
+				r = next;
+			}
+		}
+
+		/*************************** Members Methods **************************/
+		/* ptr has just been unlinked; the caller has to be pinned. */
+		void retire(void *ptr) {
+			Record_ *r = local();
+			Retired_ item = { ptr, _epoch.load(std::memory_order_seq_cst) };
+
+			r->retired.push_back(item);
+			if (r->retired.size() % _collect_every == 0)
+				collect(r);
+		}
+
+	private:
+		static unsigned long long nextId() {
+			static std::atomic<unsigned long long> id(1);
+			return id.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		/* The calling thread's record, cached per thread for the last domain
+		** it used; ids are never reused, so a stale cache cannot match. A
+		** thread new to the domain takes over a record given up by one that
+		** exited before adding its own, and forgets records of domains that
+		** are gone. */
+		Record_* local() {
+			static thread_local unsigned long long	cached_id = 0;
+			static thread_local Record_				*cached = 0;
+			static thread_local Held_				held;
+			Record_									*r = 0;
+			std::size_t								i;
+
+			if (cached_id == _id)
+				return cached;
+			for (i = 0; i < held.entries.size() && held.entries[i].id != _id; ) {
+				if (held.entries[i].record->refs.load(std::memory_order_acquire) == 1) {
+					held.entries[i].record->drop();
+					held.entries[i] = held.entries.back();
+					held.entries.pop_back();
+				} else {
+					++i;
+				}
+			}
+			if (i < held.entries.size()) {
+				r = held.entries[i].record;
+			} else {
+				Held_::Entry_ entry = { _id, 0 };
+				held.entries.reserve(held.entries.size() + 1);
+				for (r = _records.load(std::memory_order_acquire); r && !claim(r); r = r->next) ;
+				if (r) {
+					r->refs.fetch_add(1, std::memory_order_relaxed);
+				} else {
+					r = new Record_();
+					r->next = _records.load(std::memory_order_relaxed);
+					while (!_records.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) ;
+				}
+				entry.record = r;
+				held.entries.push_back(entry);
+			}
+			cached_id = _id;
+			cached = r;
+			return r;
+		}
+
+		static bool claim(Record_ *r) {
+			bool free = false;
+
+			return !r->taken.load(std::memory_order_relaxed)
+				&& r->taken.compare_exchange_strong(free, true, std::memory_order_acquire, std::memory_order_relaxed);
+		}
+
+		void pin(Record_ *r) {
+			if (r->depth++) return;
+			r->state.store((_epoch.load(std::memory_order_relaxed) << 1) | 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+		}
+
+		void unpin(Record_ *r) {
+			if (--r->depth) return;
+			r->state.store(0, std::memory_order_release);
+		}
+
+		/* Moves the epoch on when every pinned thread is in it, then frees
+		** what this thread and any exited one retired at least two epochs
+		** back. */
+		void collect(Record_ *r) {
+			unsigned long long	epoch = _epoch.load(std::memory_order_seq_cst);
+			Record_				*x;
+
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			for (x = _records.load(std::memory_order_acquire); x; x = x->next) {
+				unsigned long long state = x->state.load(std::memory_order_seq_cst);
+				if ((state & 1) && (state >> 1) != epoch)
+					break;
+			}
+			if (!x)
+				_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+			epoch = _epoch.load(std::memory_order_seq_cst);
+			drain(r, epoch);
+			for (x = _records.load(std::memory_order_acquire); x; x = x->next) {
+				if (!claim(x))
+					continue;
+				drain(x, epoch);
+				x->taken.store(false, std::memory_order_release);
+			}
+		}
+
+		/* Epochs only grow, so the freeable items are a prefix of the list. */
+		void drain(Record_ *r, unsigned long long epoch) {
+			std::size_t	done = 0, i;
+
+			while (done < r->retired.size() && r->retired[done].epoch + 2 <= epoch)
+				_release(_context, r->retired[done++].ptr);
+			if (!done) return;
+			for (i = done; i < r->retired.size(); ++i)
+				r->retired[i - done] = r->retired[i];
+			while (done--)
+				r->retired.pop_back();
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,379 @@
+#pragma once
+#ifndef FLAT_MAP_HPP
+#define FLAT_MAP_HPP
+
+# include <algorithm>
+# include <functional>
+# include <limits>
+# include <stdexcept>
+# include "Iterator.hpp"
+# include "Utility.hpp"
+# include "Vector.hpp"
+
+namespace ft {
+	/*
+	** Sorted-vector map with the interface of ft::Map. Keys and mapped values
+	** are kept in two parallel ft::Vectors, so lookups only touch the key
+	** array and there is no per-element node overhead. Search picks the
+	** lookup policy (ft::BinarySearch or ft::BranchlessSearch).
+	*/
+	template <class Key, class T, class Compare = std::less<Key>,
+			class A = std::allocator<ft::pair<const Key, T> >, class Search = ft::BinarySearch>
+	class FlatMap {
+	public:
+		typedef Key															key_type;
+		typedef T															mapped_type;
+		typedef ft::pair<const Key, T>										value_type;
+		typedef std::size_t													size_type;
+		typedef std::ptrdiff_t												difference_type;
+		typedef Compare														key_compare;
+		typedef A															allocator_type;
+		typedef Search														search_policy;
+		typedef ft::pair<const Key&, T&>									reference;
+		typedef ft::pair<const Key&, const T&>								const_reference;
+		typedef ft::FlatIterator<Key, T>									iterator;
+		typedef ft::FlatIterator<Key, const T>								const_iterator;
+		typedef ft::FlatReverseIterator<iterator>							reverse_iterator;
+		typedef ft::FlatReverseIterator<const_iterator>						const_reverse_iterator;
+		typedef ft::Vector<Key, typename A::template rebind<Key>::other>	key_container;
+		typedef ft::Vector<T, typename A::template rebind<T>::other>		mapped_container;
+
+		class ValueCompare {
+			friend class FlatMap;
+		protected:
+			key_compare	comp;
+			ValueCompare(key_compare c): comp(c) {}
+		public:
+			template <class P1, class P2>
+			bool operator()(const P1& _x, const P2& _y) const { return comp(_x.first, _y.first); }
+		};
+
+	private:
+		key_container		_keys;
+		mapped_container	_values;
+		Compare				_comp;
+		allocator_type		_allocator;
+
+		/* Orders positions of a key array, for sorting a batch without moving it. */
+		struct IndexCompare_ {
+			const Key		*keys;
+			const Compare	*comp;
+			IndexCompare_(const Key *k, const Compare *c): keys(k), comp(c) {}
+			bool operator()(size_type a, size_type b) const { return (*comp)(keys[a], keys[b]); }
+		};
+
+	public:
+		/**************************** Constructors ****************************/
+		FlatMap() {}
+
+		explicit FlatMap(const Compare& comp, const A& alloc = A()) : _comp(comp), _allocator(alloc) {}
+
+		template <class InputIt>
+		FlatMap(InputIt first, InputIt last,
+				const Compare& comp = Compare(), const A& alloc = A()) : _comp(comp), _allocator(alloc) {
+			insert(first, last);
+		}
+
+		template <class InputIt>
+		FlatMap(ft::sorted_unique_t, InputIt first, InputIt last,
+				const Compare& comp = Compare(), const A& alloc = A()) : _comp(comp), _allocator(alloc) {
+			for ( ; first != last; ++first) {
+				_keys.push_back(first->first);
+				_values.push_back(first->second);
+			}
+		}
+
+		FlatMap(const FlatMap& other)
+			: _keys(other._keys), _values(other._values), _comp(other._comp), _allocator(other._allocator) {}
+
+		FlatMap& operator=(const FlatMap& other) {
+			if (this == &other)
+				return *this;
+			_keys = other._keys;
+			_values = other._values;
+			_comp = other._comp;
+			_allocator = other._allocator;
+			return *this;
+		}
+
+		~FlatMap() {}
+
+		/*************************** Members Methods **************************/
+		T& at(const Key& key) {
+			size_type i = findIndex(key);
+			if (i == size()) throw std::out_of_range("key not found");
+			return _values[i];
+		}
+
+		const T& at(const Key& key) const {
+			size_type i = findIndex(key);
+			if (i == size()) throw std::out_of_range("key not found");
+			return _values[i];
+		}
+
+		T& operator[](const Key& key) {
+			size_type i = lowerIndex(key);
+			if (i == size() || _comp(key, _keys[i]))
+				insertAt(i, key, T());
+			return _values[i];
+		}
+
+		allocator_type			get_allocator() const		{ return _allocator; }
+		iterator				begin()						{ return makeIterator(0); }
+		const_iterator			begin() const				{ return makeIterator(0); }
+		iterator				end()						{ return makeIterator(size()); }
+		const_iterator			end() const					{ return makeIterator(size()); }
+		reverse_iterator		rbegin()					{ return reverse_iterator(end()); }
+		const_reverse_iterator	rbegin() const				{ return const_reverse_iterator(end()); }
+		reverse_iterator		rend()						{ return reverse_iterator(begin()); }
+		const_reverse_iterator	rend() const				{ return const_reverse_iterator(begin()); }
+		bool					empty() const				{ return _keys.empty(); }
+		size_type				size() const				{ return _keys.size(); }
+		size_type				max_size() const			{ return std::min(_keys.max_size(), _values.max_size()); }
+		const key_container&	keys() const				{ return _keys; }
+		const mapped_container&	values() const				{ return _values; }
+
+		void clear() {
+			_keys.clear();
+			_values.clear();
+		}
+
+		void reserve( size_type count ) {
+			_keys.reserve(count);
+			_values.reserve(count);
+		}
+
+		ft::pair<iterator, bool> insert( const value_type& value ) {
+			size_type i = lowerIndex(value.first);
+
+			if (i != size() && !_comp(value.first, _keys[i]))
+				return ft::make_pair(makeIterator(i), false);
+			insertAt(i, value.first, value.second);
+			return ft::make_pair(makeIterator(i), true);
+		}
+
+		iterator insert( iterator hint, const value_type& value ) {
+			size_type i = hint.keyBase() - _keys.data();
+
+			if ((i == size() || _comp(value.first, _keys[i])) && (i == 0 || _comp(_keys[i - 1], value.first))) {
+				insertAt(i, value.first, value.second);
+				return makeIterator(i);
+			}
+			return insert(value).first;
+		}
+
+		template <class InputIt>
+		void insert( InputIt first, InputIt last ) {
+			key_container keys;
+			mapped_container values;
+
+			for ( ; first != last; ++first) {
+				keys.push_back(first->first);
+				values.push_back(first->second);
+			}
+			mergeIn(keys, values, false);
+		}
+
+		template <class InputIt>
+		void insert( ft::sorted_unique_t, InputIt first, InputIt last ) {
+			key_container keys;
+			mapped_container values;
+
+			for ( ; first != last; ++first) {
+				keys.push_back(first->first);
+				values.push_back(first->second);
+			}
+			mergeIn(keys, values, true);
+		}
+
+		void erase( iterator pos ) {
+			size_type i = pos.keyBase() - _keys.data();
+
+			_keys.erase(_keys.begin() + i);
+			_values.erase(_values.begin() + i);
+		}
+
+		void erase( iterator first, iterator last ) {
+			size_type i = first.keyBase() - _keys.data();
+			size_type j = last.keyBase() - _keys.data();
+
+			_keys.erase(_keys.begin() + i, _keys.begin() + j);
+			_values.erase(_values.begin() + i, _values.begin() + j);
+		}
+
+		size_type erase( const key_type& key ) {
+			return eraseIndex(findIndex(key));
+		}
+
+		void swap( FlatMap& other ) {
+			_keys.swap(other._keys);
+			_values.swap(other._values);
+			std::swap(_comp, other._comp);
+			std::swap(_allocator, other._allocator);
+		}
+
+		size_type				count( const Key& key ) const		{ return findIndex(key) == size() ? 0 : 1; }
+		iterator				find( const Key& key )				{ return makeIterator(findIndex(key)); }
+		const_iterator			find( const Key& key ) const		{ return makeIterator(findIndex(key)); }
+		iterator				lower_bound( const Key& key )		{ return makeIterator(lowerIndex(key)); }
+		const_iterator			lower_bound( const Key& key ) const	{ return makeIterator(lowerIndex(key)); }
+		iterator				upper_bound( const Key& key )		{ return makeIterator(upperIndex(key)); }
+		const_iterator			upper_bound( const Key& key ) const	{ return makeIterator(upperIndex(key)); }
+
+		ft::pair<iterator,iterator> equal_range( const Key& key ) {
+			return ft::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+		}
+
+		ft::pair<const_iterator,const_iterator> equal_range( const Key& key ) const {
+			return ft::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+		}
+
+		/* Heterogeneous lookup, as in ft::Map. */
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		find( const K& key )					{ return makeIterator(findIndex(key)); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, const_iterator>::type
+		find( const K& key ) const				{ return makeIterator(findIndex(key)); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, size_type>::type
+		count( const K& key ) const				{ return findIndex(key) == size() ? 0 : 1; }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		lower_bound( const K& key )				{ return makeIterator(lowerIndex(key)); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, const_iterator>::type
+		lower_bound( const K& key ) const		{ return makeIterator(lowerIndex(key)); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		upper_bound( const K& key )				{ return makeIterator(upperIndex(key)); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, const_iterator>::type
+		upper_bound( const K& key ) const		{ return makeIterator(upperIndex(key)); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, ft::pair<iterator, iterator> >::type
+		equal_range( const K& key ) {
+			return ft::pair<iterator, iterator>(makeIterator(lowerIndex(key)), makeIterator(upperIndex(key)));
+		}
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, ft::pair<const_iterator, const_iterator> >::type
+		equal_range( const K& key ) const {
+			return ft::pair<const_iterator, const_iterator>(makeIterator(lowerIndex(key)), makeIterator(upperIndex(key)));
+		}
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value && !std::is_convertible<K, iterator>::value, size_type>::type
+		erase( const K& key )					{ return eraseIndex(findIndex(key)); }
+
+		key_compare key_comp() const { return _comp; }
+
+		ValueCompare value_comp() const { return ValueCompare(key_comp()); }
+
+		friend bool operator== (const FlatMap &lhs, const FlatMap &rhs) { return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin()); }
+		friend bool operator!= (const FlatMap &lhs, const FlatMap &rhs) { return !(lhs == rhs); }
+		friend bool operator< (const FlatMap &lhs, const FlatMap &rhs) { return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); }
+		friend bool operator> (const FlatMap &lhs, const FlatMap &rhs) { return rhs < lhs; }
+		friend bool operator>= (const FlatMap &lhs, const FlatMap &rhs) { return !(lhs < rhs); }
+		friend bool operator<= (const FlatMap &lhs, const FlatMap &rhs) { return !(rhs < lhs); }
+
+	private:
+		iterator		makeIterator(size_type i)		{ return iterator(_keys.data() + i, _values.data() + i); }
+		const_iterator	makeIterator(size_type i) const	{ return const_iterator(_keys.data() + i, _values.data() + i); }
+
+		template <class K>
+		size_type lowerIndex(const K& key) const { return Search::lower(_keys.data(), size(), key, _comp); }
+
+		template <class K>
+		size_type upperIndex(const K& key) const { return Search::upper(_keys.data(), size(), key, _comp); }
+
+		template <class K>
+		size_type findIndex(const K& key) const {
+			size_type i = lowerIndex(key);
+
+			return (i == size() || _comp(key, _keys[i])) ? size() : i;
+		}
+
+		size_type eraseIndex(size_type i) {
+			if (i == size()) return 0;
+			_keys.erase(_keys.begin() + i);
+			_values.erase(_values.begin() + i);
+			return 1;
+		}
+
+		void insertAt(size_type i, const Key& key, const T& value) {
+			_keys.push_back(key);
+			_values.push_back(value);
+			for (size_type j = size() - 1; j > i; --j) {
+				_keys[j] = _keys[j - 1];
+				_values[j] = _values[j - 1];
+			}
+			_keys[i] = key;
+			_values[i] = value;
+		}
+
+		bool inOrder(const key_container& keys) const {
+			for (size_type k = 1; k < keys.size(); ++k)
+				if (!_comp(keys[k - 1], keys[k])) return false;
+			return true;
+		}
+
+		/* Adds a batch in one pass. The batch is stably sorted through an index
+		** array unless sorted vouches for it or it is already in order, so the
+		** first of equal keys wins like with repeated insert(); keys already
+		** present are kept. A batch that lands entirely past the current last
+		** key is appended in place. */
+		void mergeIn(const key_container& keys, const mapped_container& values, bool sorted) {
+			size_type n = keys.size(), i = 0, j = 0;
+			ft::Vector<size_type> order;
+
+			if (!n) return;
+			order.reserve(n);
+			for (size_type k = 0; k < n; ++k)
+				order.push_back(k);
+			if (!sorted && !inOrder(keys))
+				std::stable_sort(order.data(), order.data() + n, IndexCompare_(keys.data(), &_comp));
+			if (empty() || _comp(_keys.back(), keys[order[0]])) {
+				reserve(size() + n);
+				for ( ; j < n; ) {
+					const Key& key = keys[order[j]];
+					_keys.push_back(key);
+					_values.push_back(values[order[j]]);
+					for (++j; j < n && !_comp(key, keys[order[j]]); ++j) ;
+				}
+				return;
+			}
+			key_container mergedKeys;
+			mapped_container mergedValues;
+			mergedKeys.reserve(size() + n);
+			mergedValues.reserve(size() + n);
+			while (i < size() || j < n) {
+				if (j == n || (i < size() && _comp(_keys[i], keys[order[j]]))) {
+					mergedKeys.push_back(_keys[i]);
+					mergedValues.push_back(_values[i++]);
+					continue;
+				}
+				const Key& key = keys[order[j]];
+				if (i < size() && !_comp(key, _keys[i])) {
+					mergedKeys.push_back(_keys[i]);
+					mergedValues.push_back(_values[i++]);
+				} else {
+					mergedKeys.push_back(key);
+					mergedValues.push_back(values[order[j]]);
+				}
+				for (++j; j < n && !_comp(key, keys[order[j]]); ++j) ;
+			}
+			_keys.swap(mergedKeys);
+			_values.swap(mergedValues);
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,266 @@
+#pragma once
+#ifndef FLAT_SET_HPP
+#define FLAT_SET_HPP
+
+# include <algorithm>
+# include <functional>
+# include "Iterator.hpp"
+# include "Utility.hpp"
+# include "Vector.hpp"
+
+namespace ft {
+	/*
+	** Sorted-vector set with the interface of ft::Set, backed by a single
+	** ft::Vector of keys. Search picks the lookup policy (ft::BinarySearch or
+	** ft::BranchlessSearch).
+	*/
+	template <class Key, class Compare = std::less<Key>, class A = std::allocator<Key>,
+			class Search = ft::BinarySearch>
+	class FlatSet {
+	public:
+		typedef Key											key_type;
+		typedef Key											value_type;
+		typedef std::size_t									size_type;
+		typedef std::ptrdiff_t								difference_type;
+		typedef Compare										key_compare;
+		typedef Compare										value_compare;
+		typedef A											allocator_type;
+		typedef Search										search_policy;
+		typedef const value_type&							reference;
+		typedef const value_type&							const_reference;
+		typedef ft::Vector<Key, A>							key_container;
+		typedef typename key_container::const_iterator		iterator;
+		typedef typename key_container::const_iterator		const_iterator;
+		typedef ft::FlatReverseIterator<iterator>			reverse_iterator;
+		typedef ft::FlatReverseIterator<const_iterator>		const_reverse_iterator;
+
+	private:
+		key_container		_keys;
+		Compare				_comp;
+
+		struct IndexCompare_ {
+			const Key		*keys;
+			const Compare	*comp;
+			IndexCompare_(const Key *k, const Compare *c): keys(k), comp(c) {}
+			bool operator()(size_type a, size_type b) const { return (*comp)(keys[a], keys[b]); }
+		};
+
+	public:
+		/**************************** Constructors ****************************/
+		FlatSet() {}
+
+		explicit FlatSet(const Compare& comp, const A& alloc = A()) : _keys(alloc), _comp(comp) {}
+
+		template <class InputIt>
+		FlatSet(InputIt first, InputIt last,
+				const Compare& comp = Compare(), const A& alloc = A()) : _keys(alloc), _comp(comp) {
+			insert(first, last);
+		}
+
+		template <class InputIt>
+		FlatSet(ft::sorted_unique_t, InputIt first, InputIt last,
+				const Compare& comp = Compare(), const A& alloc = A()) : _keys(alloc), _comp(comp) {
+			for ( ; first != last; ++first)
+				_keys.push_back(*first);
+		}
+
+		FlatSet(const FlatSet& other) : _keys(other._keys), _comp(other._comp) {}
+
+		FlatSet& operator=(const FlatSet& other) {
+			if (this == &other)
+				return *this;
+			_keys = other._keys;
+			_comp = other._comp;
+			return *this;
+		}
+
+		~FlatSet() {}
+
+		/*************************** Members Methods **************************/
+		allocator_type			get_allocator() const	{ return _keys.getAllocator(); }
+		iterator				begin() const			{ return makeIterator(0); }
+		iterator				end() const				{ return makeIterator(size()); }
+		reverse_iterator		rbegin() const			{ return reverse_iterator(end()); }
+		reverse_iterator		rend() const			{ return reverse_iterator(begin()); }
+		bool					empty() const			{ return _keys.empty(); }
+		size_type				size() const			{ return _keys.size(); }
+		size_type				max_size() const		{ return _keys.max_size(); }
+		const key_container&	keys() const			{ return _keys; }
+
+		void clear()						{ _keys.clear(); }
+		void reserve( size_type count )		{ _keys.reserve(count); }
+
+		ft::pair<iterator, bool> insert( const value_type& value ) {
+			size_type i = lowerIndex(value);
+
+			if (i != size() && !_comp(value, _keys[i]))
+				return ft::make_pair(makeIterator(i), false);
+			insertAt(i, value);
+			return ft::make_pair(makeIterator(i), true);
+		}
+
+		iterator insert( iterator hint, const value_type& value ) {
+			size_type i = hint.base() - _keys.data();
+
+			if ((i == size() || _comp(value, _keys[i])) && (i == 0 || _comp(_keys[i - 1], value))) {
+				insertAt(i, value);
+				return makeIterator(i);
+			}
+			return insert(value).first;
+		}
+
+		template <class InputIt>
+		void insert( InputIt first, InputIt last ) {
+			key_container keys;
+
+			for ( ; first != last; ++first)
+				keys.push_back(*first);
+			mergeIn(keys, false);
+		}
+
+		template <class InputIt>
+		void insert( ft::sorted_unique_t, InputIt first, InputIt last ) {
+			key_container keys;
+
+			for ( ; first != last; ++first)
+				keys.push_back(*first);
+			mergeIn(keys, true);
+		}
+
+		void erase( iterator pos ) {
+			_keys.erase(_keys.begin() + (pos.base() - _keys.data()));
+		}
+
+		void erase( iterator first, iterator last ) {
+			_keys.erase(_keys.begin() + (first.base() - _keys.data()), _keys.begin() + (last.base() - _keys.data()));
+		}
+
+		size_type erase( const key_type& key ) {
+			return eraseIndex(findIndex(key));
+		}
+
+		void swap( FlatSet& other ) {
+			_keys.swap(other._keys);
+			std::swap(_comp, other._comp);
+		}
+
+		size_type		count( const Key& key ) const		{ return findIndex(key) == size() ? 0 : 1; }
+		iterator		find( const Key& key ) const		{ return makeIterator(findIndex(key)); }
+		iterator		lower_bound( const Key& key ) const	{ return makeIterator(lowerIndex(key)); }
+		iterator		upper_bound( const Key& key ) const	{ return makeIterator(upperIndex(key)); }
+
+		ft::pair<iterator,iterator> equal_range( const Key& key ) const {
+			return ft::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+		}
+
+		/* Heterogeneous lookup, as in ft::Set. */
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		find( const K& key ) const				{ return makeIterator(findIndex(key)); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, size_type>::type
+		count( const K& key ) const				{ return findIndex(key) == size() ? 0 : 1; }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		lower_bound( const K& key ) const		{ return makeIterator(lowerIndex(key)); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		upper_bound( const K& key ) const		{ return makeIterator(upperIndex(key)); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, ft::pair<iterator, iterator> >::type
+		equal_range( const K& key ) const {
+			return ft::pair<iterator, iterator>(makeIterator(lowerIndex(key)), makeIterator(upperIndex(key)));
+		}
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value && !std::is_convertible<K, iterator>::value, size_type>::type
+		erase( const K& key )					{ return eraseIndex(findIndex(key)); }
+
+		key_compare key_comp() const { return _comp; }
+		value_compare value_comp() const { return _comp; }
+		friend bool operator== (const FlatSet &lhs, const FlatSet &rhs) { return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin()); }
+		friend bool operator!= (const FlatSet &lhs, const FlatSet &rhs) { return !(lhs == rhs); }
+		friend bool operator< (const FlatSet &lhs, const FlatSet &rhs) { return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); }
+		friend bool operator> (const FlatSet &lhs, const FlatSet &rhs) { return rhs < lhs; }
+		friend bool operator>= (const FlatSet &lhs, const FlatSet &rhs) { return !(lhs < rhs); }
+		friend bool operator<= (const FlatSet &lhs, const FlatSet &rhs) { return !(rhs < lhs); }
+
+	private:
+		iterator makeIterator(size_type i) const { return iterator(_keys.data() + i); }
+
+		template <class K>
+		size_type lowerIndex(const K& key) const { return Search::lower(_keys.data(), size(), key, _comp); }
+
+		template <class K>
+		size_type upperIndex(const K& key) const { return Search::upper(_keys.data(), size(), key, _comp); }
+
+		template <class K>
+		size_type findIndex(const K& key) const {
+			size_type i = lowerIndex(key);
+
+			return (i == size() || _comp(key, _keys[i])) ? size() : i;
+		}
+
+		size_type eraseIndex(size_type i) {
+			if (i == size()) return 0;
+			_keys.erase(_keys.begin() + i);
+			return 1;
+		}
+
+		void insertAt(size_type i, const value_type& value) {
+			_keys.push_back(value);
+			for (size_type j = size() - 1; j > i; --j)
+				_keys[j] = _keys[j - 1];
+			_keys[i] = value;
+		}
+
+		bool inOrder(const key_container& keys) const {
+			for (size_type k = 1; k < keys.size(); ++k)
+				if (!_comp(keys[k - 1], keys[k])) return false;
+			return true;
+		}
+
+		/* Same single-pass batch merge as ft::FlatMap::mergeIn. */
+		void mergeIn(const key_container& keys, bool sorted) {
+			size_type n = keys.size(), i = 0, j = 0;
+			ft::Vector<size_type> order;
+
+			if (!n) return;
+			order.reserve(n);
+			for (size_type k = 0; k < n; ++k)
+				order.push_back(k);
+			if (!sorted && !inOrder(keys))
+				std::stable_sort(order.data(), order.data() + n, IndexCompare_(keys.data(), &_comp));
+			if (empty() || _comp(_keys.back(), keys[order[0]])) {
+				reserve(size() + n);
+				for ( ; j < n; ) {
+					const Key& key = keys[order[j]];
+					_keys.push_back(key);
+					for (++j; j < n && !_comp(key, keys[order[j]]); ++j) ;
+				}
+				return;
+			}
+			key_container merged;
+			merged.reserve(size() + n);
+			while (i < size() || j < n) {
+				if (j == n || (i < size() && _comp(_keys[i], keys[order[j]]))) {
+					merged.push_back(_keys[i++]);
+					continue;
+				}
+				const Key& key = keys[order[j]];
+				if (i < size() && !_comp(key, _keys[i]))
+					merged.push_back(_keys[i++]);
+				else
+					merged.push_back(key);
+				for (++j; j < n && !_comp(key, keys[order[j]]); ++j) ;
+			}
+			_keys.swap(merged);
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,272 @@
+#pragma once
+#ifndef HASH_TABLE_HPP
+#define HASH_TABLE_HPP
+
+# include <memory>
+# include <cstddef>
+# include <cstring>
+# include <stdexcept>
+# include <utility>
+# include "Iterator.hpp"
+# include "Utility.hpp"
+
+namespace ft {
+	/*
+	** Open-addressing hash table backing ft::UnorderedMap and ft::UnorderedSet.
+	** Slots live in one contiguous array next to a byte array holding each
+	** slot's probe distance plus one (0 marks an empty slot). Robin Hood
+	** placement keeps every run ordered by home slot, so a lookup stops as
+	** soon as it meets a slot closer to its home than the probe, and erase
+	** shifts the rest of the run back instead of leaving tombstones.
+	*/
+	template <class Value, class Key, class KeyOfValue, class Hash, class KeyEqual, class A>
+	class HashTable {
+	public:
+		typedef std::size_t											size_type;
+		typedef ft::HashIterator<Value>								iterator;
+		typedef ft::HashIterator<const Value>						const_iterator;
+		typedef typename A::template rebind<Value>::other			allocator_value;
+		typedef typename A::template rebind<unsigned char>::other	allocator_dist;
+
+	private:
+		static const size_type		_min_capacity = 16;
+		static const unsigned char	_max_dist = 255;
+		static const size_type		_npos = static_cast<size_type>(-1);
+
+		allocator_value		_allocator_value;
+		allocator_dist		_allocator_dist;
+		Hash				_hash;
+		KeyEqual			_eq;
+		KeyOfValue			_key;
+		Value				*_slots;
+		unsigned char		*_dist;
+		size_type			_capacity;
+		size_type			_size;
+		unsigned			_shift;
+		float				_max_load;
+
+		/* Shared by every empty table: a non-zero byte that stops iteration. */
+		static unsigned char* emptyDist() { static unsigned char sentinel = 1; return &sentinel; }
+
+	public:
+		/**************************** Constructors ****************************/
+		explicit HashTable(const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual(), const A& alloc = A())
+			: _allocator_value(alloc), _allocator_dist(alloc), _hash(hash), _eq(eq),
+			_slots(NULL), _dist(emptyDist()), _capacity(0), _size(0), _shift(64), _max_load(0.875f) {}
+
+		HashTable(const HashTable& other)
+			: _allocator_value(other._allocator_value), _allocator_dist(other._allocator_dist),
+			_hash(other._hash), _eq(other._eq), _slots(NULL), _dist(emptyDist()),
+			_capacity(0), _size(0), _shift(64), _max_load(other._max_load) {
+			if (!other._size)
+				return;
+			allocate(other._capacity);
+			for (size_type i = 0; i < _capacity; ++i) {
+				_dist[i] = other._dist[i];
+				if (_dist[i])
+					_allocator_value.construct(_slots + i, other._slots[i]);
+			}
+			_size = other._size;
+		}
+
+		HashTable& operator=(const HashTable& other) {
+			if (this == &other)
+				return *this;
+			HashTable tmp(other);
+			swap(tmp);
+			return *this;
+		}
+
+		~HashTable() { release(); }
+
+		/*************************** Members Methods **************************/
+		iterator		begin()				{ size_type i = firstSlot(); return iterator(_slots + i, _dist + i); }
+		const_iterator	begin() const		{ size_type i = firstSlot(); return const_iterator(_slots + i, _dist + i); }
+		iterator		end()				{ return iterator(_slots + _capacity, _dist + _capacity); }
+		const_iterator	end() const			{ return const_iterator(_slots + _capacity, _dist + _capacity); }
+		size_type		size() const		{ return _size; }
+		size_type		capacity() const	{ return _capacity; }
+		Hash			hash() const		{ return _hash; }
+		KeyEqual		eq() const			{ return _eq; }
+		float			maxLoad() const		{ return _max_load; }
+
+		void maxLoad(float ml) {
+			_max_load = ml < 0.25f ? 0.25f : ml > 0.95f ? 0.95f : ml;
+			if (_size)
+				reserve(_size);
+		}
+
+		void clear() {
+			for (size_type i = 0; _size && i < _capacity; ++i)
+				if (_dist[i]) {
+					_allocator_value.destroy(_slots + i);
+					_dist[i] = 0;
+					--_size;
+				}
+		}
+
+		void swap(HashTable& other) {
+			std::swap(_hash, other._hash);
+			std::swap(_eq, other._eq);
+			std::swap(_slots, other._slots);
+			std::swap(_dist, other._dist);
+			std::swap(_capacity, other._capacity);
+			std::swap(_size, other._size);
+			std::swap(_shift, other._shift);
+			std::swap(_max_load, other._max_load);
+		}
+
+		/* Rounds up to a power of two that also keeps size() under the load cap. */
+		void rehash(size_type count) {
+			size_type capacity = _min_capacity;
+
+			if (count < static_cast<size_type>(_size / _max_load) + 1)
+				count = static_cast<size_type>(_size / _max_load) + 1;
+			while (capacity < count)
+				capacity *= 2;
+			if (capacity != _capacity)
+				resize(capacity);
+		}
+
+		void reserve(size_type count) {
+			if (count > _capacity * _max_load || !_capacity)
+				rehash(static_cast<size_type>(count / _max_load) + 1);
+		}
+
+		template <class K>
+		iterator find(const K& key) const {
+			size_type i = findIndex(key);
+
+			if (i == _npos)
+				return iterator(_slots + _capacity, _dist + _capacity);
+			return iterator(_slots + i, _dist + i);
+		}
+
+		ft::pair<iterator, bool> insertUnique(const Value& value) {
+			size_type i = findIndex(_key(value));
+
+			if (i != _npos)
+				return ft::make_pair(iterator(_slots + i, _dist + i), false);
+			if (_size + 1 > _capacity * _max_load)
+				resize(_capacity ? _capacity * 2 : _min_capacity);
+			while ((i = place(value)) == _npos) {
+				if (_size * 8 < _capacity)
+					throw std::overflow_error("ft::HashTable: probe distance overflow");
+				resize(_capacity * 2);
+			}
+			return ft::make_pair(iterator(_slots + i, _dist + i), true);
+		}
+
+		/* Backward-shift delete: later members of the run move one slot back. */
+		void erase(iterator pos) {
+			size_type i = pos.slot() - _slots, j = next(i);
+
+			_allocator_value.destroy(_slots + i);
+			for ( ; _dist[j] > 1; i = j, j = next(j)) {
+				relocate(_slots + i, _slots + j);
+				_dist[i] = _dist[j] - 1;
+			}
+			_dist[i] = 0;
+			--_size;
+		}
+
+	private:
+		size_type next(size_type i) const { return (i + 1) & (_capacity - 1); }
+		size_type prev(size_type i) const { return (i - 1) & (_capacity - 1); }
+
+		/* Fibonacci hashing: the multiply spreads weak hashes such as the
+		** identity std::hash<int> over the high bits used for the index. */
+		template <class K>
+		size_type home(const K& key) const {
+			return static_cast<size_type>((static_cast<unsigned long long>(_hash(key)) * 0x9E3779B97F4A7C15ULL) >> _shift);
+		}
+
+		template <class K>
+		size_type findIndex(const K& key) const {
+			if (!_size)
+				return _npos;
+			size_type i = home(key);
+			for (unsigned char d = 1; _dist[i] >= d; i = next(i), ++d)
+				if (_dist[i] == d && _eq(key, _key(_slots[i])))
+					return i;
+			return _npos;
+		}
+
+		/* Puts value where Robin Hood ordering wants it and shifts the rest of
+		** the run forward by one. Returns _npos, leaving the table untouched,
+		** if a probe distance would no longer fit in a byte. */
+		size_type place(const Value& value) {
+			size_type i = home(_key(value)), e;
+			unsigned char d = 1;
+
+			for ( ; _dist[i] >= d; i = next(i))
+				if (++d == _max_dist)
+					return _npos;
+			for (e = i; _dist[e]; e = next(e))
+				if (_dist[e] + 1 == _max_dist)
+					return _npos;
+			for ( ; e != i; e = prev(e)) {
+				relocate(_slots + e, _slots + prev(e));
+				_dist[e] = _dist[prev(e)] + 1;
+			}
+			_allocator_value.construct(_slots + i, value);
+			_dist[i] = d;
+			++_size;
+			return i;
+		}
+
+		void resize(size_type capacity) {
+			Value *slots = _slots;
+			unsigned char *dist = _dist;
+			size_type old = _capacity;
+
+			allocate(capacity);
+			_size = 0;
+			for (size_type i = 0; i < old; ++i)
+				if (dist[i]) {
+					if (place(slots[i]) == _npos)
+						throw std::overflow_error("ft::HashTable: probe distance overflow");
+					_allocator_value.destroy(slots + i);
+				}
+			if (old) {
+				_allocator_value.deallocate(slots, old);
+				_allocator_dist.deallocate(dist, old + 1);
+			}
+		}
+
+		/* Fresh, empty arrays; the extra distance byte is the end sentinel. */
+		void allocate(size_type capacity) {
+			_slots = _allocator_value.allocate(capacity);
+			_dist = _allocator_dist.allocate(capacity + 1);
+			std::memset(_dist, 0, capacity);
+			_dist[capacity] = 1;
+			_capacity = capacity;
+			for (_shift = 64; capacity > 1; capacity /= 2)
+				--_shift;
+		}
+
+		void release() {
+			clear();
+			if (_capacity) {
+				_allocator_value.deallocate(_slots, _capacity);
+				_allocator_dist.deallocate(_dist, _capacity + 1);
+			}
+		}
+
+		/* Moves a value to an empty slot, copying only when its move may throw. */
+		void relocate(Value *dst, Value *src) {
+			_allocator_value.construct(dst, std::move_if_noexcept(*src));
+			_allocator_value.destroy(src);
+		}
+
+		size_type firstSlot() const {
+			size_type i = 0;
+
+			while (!_dist[i])
+				++i;
+			return i;
+		}
+	};
+}
+
+#endif
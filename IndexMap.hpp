@@ -0,0 +1,224 @@
+#pragma once
+#ifndef INDEX_MAP_HPP
+#define INDEX_MAP_HPP
+
+# include <functional>
+# include <stdexcept>
+# include "IndexTree.hpp"
+# include "Iterator.hpp"
+# include "Utility.hpp"
+
+namespace ft {
+	/*
+	** Ordered map with the interface of ft::Map, stored in a red-black tree
+	** whose nodes sit in one array and link by 32-bit index: smaller nodes,
+	** one allocation, and copies without fix-ups. Iterators survive inserts
+	** and erases of other elements, but an insert that grows the array moves
+	** the values, so hold on to keys rather than references, or reserve().
+	*/
+	template <class Key, class T, class Compare = std::less<Key>, class A = std::allocator<ft::pair<const Key, T> > >
+	class IndexMap {
+	public:
+		typedef Key																	key_type;
+		typedef T																	mapped_type;
+		typedef ft::pair<const Key, T>												value_type;
+		typedef std::size_t															size_type;
+		typedef std::ptrdiff_t														difference_type;
+		typedef Compare																key_compare;
+		typedef A																	allocator_type;
+		typedef value_type&															reference;
+		typedef const value_type&													const_reference;
+		typedef ft::IndexTree<value_type, Key, ft::SelectFirst_<value_type>, Compare, A>	tree_type;
+		typedef typename tree_type::iterator										iterator;
+		typedef typename tree_type::const_iterator									const_iterator;
+		typedef ft::ReverseIterator<iterator>										reverse_iterator;
+		typedef ft::ReverseIterator<const_iterator>									const_reverse_iterator;
+
+		class ValueCompare {
+			friend class IndexMap;
+		protected:
+			key_compare	comp;
+			ValueCompare(key_compare c): comp(c) {}
+		public:
+			bool operator()(const value_type& _x, const value_type& _y) const { return comp(_x.first, _y.first); }
+		};
+
+	private:
+		allocator_type		_allocator;
+		tree_type			_tree;
+
+	public:
+		/**************************** Constructors ****************************/
+		IndexMap() {}
+
+		explicit IndexMap(const Compare& comp, const A& alloc = A()) : _allocator(alloc), _tree(comp, alloc) {}
+
+		template <class InputIt>
+		IndexMap(InputIt first, InputIt last,
+				const Compare& comp = Compare(), const A& alloc = A()) : _allocator(alloc), _tree(comp, alloc) {
+			insert(first, last);
+		}
+
+		template <class InputIt>
+		IndexMap(ft::sorted_unique_t, InputIt first, InputIt last,
+				const Compare& comp = Compare(), const A& alloc = A()) : _allocator(alloc), _tree(comp, alloc) {
+			insert(ft::sorted_unique, first, last);
+		}
+
+		IndexMap(const IndexMap& other) : _allocator(other._allocator), _tree(other._tree) {}
+
+		IndexMap& operator=(const IndexMap& other) {
+			if (this == &other)
+				return *this;
+			_allocator = other._allocator;
+			_tree = other._tree;
+			return *this;
+		}
+
+		~IndexMap() {}
+
+		/*************************** Members Methods **************************/
+		T& at(const Key& key) {
+			iterator tmp = find(key);
+			return (tmp == end()) ? throw std::out_of_range("key not found") : tmp->second;
+		}
+
+		const T& at(const Key& key) const {
+			const_iterator tmp = find(key);
+			return (tmp == end()) ? throw std::out_of_range("key not found") : tmp->second;
+		}
+
+		allocator_type			get_allocator() const		{ return _allocator; }
+		T&						operator[](const Key& key)	{ return insert(ft::make_pair(key, T())).first->second; }
+		iterator				begin()						{ return _tree.begin(); }
+		const_iterator			begin() const				{ return _tree.begin(); }
+		iterator				end()						{ return _tree.end(); }
+		const_iterator			end() const					{ return _tree.end(); }
+		reverse_iterator		rbegin()					{ return reverse_iterator(--end()); }
+		const_reverse_iterator	rbegin() const				{ return const_reverse_iterator(--end()); }
+		reverse_iterator		rend()						{ return reverse_iterator(--begin()); }
+		const_reverse_iterator	rend() const				{ return const_reverse_iterator(--begin()); }
+		bool					empty() const				{ return size() == 0; }
+		size_type				size() const				{ return _tree.size(); }
+		size_type				max_size() const			{ return _tree.max_size(); }
+
+		void clear()										{ _tree.clear(); }
+		void reserve( size_type count )						{ _tree.reserve(count); }
+
+		ft::pair<iterator, bool> insert( const value_type& value ) {
+			return _tree.insertUnique(value);
+		}
+
+		iterator insert( iterator hint, const value_type& value ) {
+			return _tree.insertHint(hint, value);
+		}
+
+		/* Sorted input keeps hitting the end hint and skips the descent. */
+		template <class InputIt>
+		void insert( InputIt first, InputIt last ) {
+			for ( ; first != last; ++first)
+				_tree.insertHint(end(), *first);
+		}
+
+		template <class InputIt>
+		void insert( ft::sorted_unique_t, InputIt first, InputIt last ) {
+			insert(first, last);
+		}
+
+		void erase( iterator pos )							{ _tree.erase(pos); }
+		void erase( iterator first, iterator last )			{ _tree.erase(first, last); }
+
+		size_type erase( const key_type& key ) {
+			iterator pos = find(key);
+
+			if (pos == end()) return 0;
+			_tree.erase(pos);
+			return 1;
+		}
+
+		void swap( IndexMap& other ) {
+			std::swap(_allocator, other._allocator);
+			_tree.swap(other._tree);
+		}
+
+		size_type				count( const Key& key ) const		{ return find(key) == end() ? 0 : 1; }
+		iterator				find( const Key& key )				{ return _tree.find(key); }
+		const_iterator			find( const Key& key ) const		{ return _tree.find(key); }
+		iterator				lower_bound( const Key& key )		{ return _tree.lowerBound(key); }
+		const_iterator			lower_bound( const Key& key ) const	{ return _tree.lowerBound(key); }
+		iterator				upper_bound( const Key& key )		{ return _tree.upperBound(key); }
+		const_iterator			upper_bound( const Key& key ) const	{ return _tree.upperBound(key); }
+
+		ft::pair<iterator,iterator> equal_range( const Key& key ) {
+			return ft::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+		}
+
+		ft::pair<const_iterator,const_iterator> equal_range( const Key& key ) const {
+			return ft::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+		}
+
+		/* Heterogeneous lookup, as in ft::Map. */
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		find( const K& key )					{ return _tree.find(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, const_iterator>::type
+		find( const K& key ) const				{ return _tree.find(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, size_type>::type
+		count( const K& key ) const				{ return find(key) == end() ? 0 : 1; }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		lower_bound( const K& key )				{ return _tree.lowerBound(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, const_iterator>::type
+		lower_bound( const K& key ) const		{ return _tree.lowerBound(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		upper_bound( const K& key )				{ return _tree.upperBound(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, const_iterator>::type
+		upper_bound( const K& key ) const		{ return _tree.upperBound(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, ft::pair<iterator, iterator> >::type
+		equal_range( const K& key ) {
+			return ft::pair<iterator, iterator>(_tree.lowerBound(key), _tree.upperBound(key));
+		}
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, ft::pair<const_iterator, const_iterator> >::type
+		equal_range( const K& key ) const {
+			return ft::pair<const_iterator, const_iterator>(_tree.lowerBound(key), _tree.upperBound(key));
+		}
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value && !std::is_convertible<K, iterator>::value, size_type>::type
+		erase( const K& key ) {
+			iterator pos = _tree.find(key);
+
+			if (pos == end()) return 0;
+			_tree.erase(pos);
+			return 1;
+		}
+
+		key_compare key_comp() const { return _tree.comp(); }
+
+		ValueCompare value_comp() const { return ValueCompare(key_comp()); }
+
+		friend bool operator== (const IndexMap &lhs, const IndexMap &rhs) { return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin()); }
+		friend bool operator!= (const IndexMap &lhs, const IndexMap &rhs) { return !(lhs == rhs); }
+		friend bool operator< (const IndexMap &lhs, const IndexMap &rhs) { return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); }
+		friend bool operator> (const IndexMap &lhs, const IndexMap &rhs) { return rhs < lhs; }
+		friend bool operator>= (const IndexMap &lhs, const IndexMap &rhs) { return !(lhs < rhs); }
+		friend bool operator<= (const IndexMap &lhs, const IndexMap &rhs) { return !(rhs < lhs); }
+	};
+}
+
+#endif
@@ -0,0 +1,176 @@
+#pragma once
+#ifndef INDEX_SET_HPP
+#define INDEX_SET_HPP
+
+# include <functional>
+# include "IndexTree.hpp"
+# include "Iterator.hpp"
+# include "Utility.hpp"
+
+namespace ft {
+	/*
+	** Ordered set with the interface of ft::Set, stored in the same
+	** index-linked tree as ft::IndexMap, with the same rules: iterators
+	** survive inserts, references may not.
+	*/
+	template <class Key, class Compare = std::less<Key>, class A = std::allocator<Key> >
+	class IndexSet {
+	public:
+		typedef Key														key_type;
+		typedef Key														value_type;
+		typedef std::size_t												size_type;
+		typedef std::ptrdiff_t											difference_type;
+		typedef Compare													key_compare;
+		typedef Compare													value_compare;
+		typedef A														allocator_type;
+		typedef const value_type&										reference;
+		typedef const value_type&										const_reference;
+		typedef ft::IndexTree<Key, Key, ft::Identity_<Key>, Compare, A>		tree_type;
+		typedef typename tree_type::const_iterator						iterator;
+		typedef typename tree_type::const_iterator						const_iterator;
+		typedef ft::ReverseIterator<iterator>							reverse_iterator;
+		typedef ft::ReverseIterator<const_iterator>						const_reverse_iterator;
+
+	private:
+		allocator_type		_allocator;
+		tree_type			_tree;
+
+	public:
+		/**************************** Constructors ****************************/
+		IndexSet() {}
+
+		explicit IndexSet(const Compare& comp, const A& alloc = A()) : _allocator(alloc), _tree(comp, alloc) {}
+
+		template <class InputIt>
+		IndexSet(InputIt first, InputIt last,
+				const Compare& comp = Compare(), const A& alloc = A()) : _allocator(alloc), _tree(comp, alloc) {
+			insert(first, last);
+		}
+
+		template <class InputIt>
+		IndexSet(ft::sorted_unique_t, InputIt first, InputIt last,
+				const Compare& comp = Compare(), const A& alloc = A()) : _allocator(alloc), _tree(comp, alloc) {
+			insert(ft::sorted_unique, first, last);
+		}
+
+		IndexSet(const IndexSet& other) : _allocator(other._allocator), _tree(other._tree) {}
+
+		IndexSet& operator=(const IndexSet& other) {
+			if (this == &other)
+				return *this;
+			_allocator = other._allocator;
+			_tree = other._tree;
+			return *this;
+		}
+
+		~IndexSet() {}
+
+		/*************************** Members Methods **************************/
+		allocator_type			get_allocator() const	{ return _allocator; }
+		iterator				begin() const			{ return _tree.begin(); }
+		iterator				end() const				{ return _tree.end(); }
+		reverse_iterator		rbegin() const			{ return reverse_iterator(--end()); }
+		reverse_iterator		rend() const			{ return reverse_iterator(--begin()); }
+		bool					empty() const			{ return size() == 0; }
+		size_type				size() const			{ return _tree.size(); }
+		size_type				max_size() const		{ return _tree.max_size(); }
+
+		void clear()									{ _tree.clear(); }
+		void reserve( size_type count )					{ _tree.reserve(count); }
+
+		ft::pair<iterator, bool> insert( const value_type& value ) {
+			ft::pair<typename tree_type::iterator, bool> ret = _tree.insertUnique(value);
+			return ft::pair<iterator, bool>(ret.first, ret.second);
+		}
+
+		iterator insert( iterator hint, const value_type& value ) {
+			return _tree.insertHint(unconst(hint), value);
+		}
+
+		template <class InputIt>
+		void insert( InputIt first, InputIt last ) {
+			for ( ; first != last; ++first)
+				_tree.insertHint(_tree.end(), *first);
+		}
+
+		template <class InputIt>
+		void insert( ft::sorted_unique_t, InputIt first, InputIt last ) {
+			insert(first, last);
+		}
+
+		void erase( iterator pos )						{ _tree.erase(unconst(pos)); }
+		void erase( iterator first, iterator last )		{ _tree.erase(unconst(first), unconst(last)); }
+
+		size_type erase( const key_type& key ) {
+			typename tree_type::iterator pos = _tree.find(key);
+
+			if (pos == _tree.end()) return 0;
+			_tree.erase(pos);
+			return 1;
+		}
+
+		void swap( IndexSet& other ) {
+			std::swap(_allocator, other._allocator);
+			_tree.swap(other._tree);
+		}
+
+		size_type		count( const Key& key ) const		{ return find(key) == end() ? 0 : 1; }
+		iterator		find( const Key& key ) const		{ return _tree.find(key); }
+		iterator		lower_bound( const Key& key ) const	{ return _tree.lowerBound(key); }
+		iterator		upper_bound( const Key& key ) const	{ return _tree.upperBound(key); }
+
+		ft::pair<iterator,iterator> equal_range( const Key& key ) const {
+			return ft::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+		}
+
+		/* Heterogeneous lookup, as in ft::Set. */
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		find( const K& key ) const				{ return _tree.find(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, size_type>::type
+		count( const K& key ) const				{ return find(key) == end() ? 0 : 1; }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		lower_bound( const K& key ) const		{ return _tree.lowerBound(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		upper_bound( const K& key ) const		{ return _tree.upperBound(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, ft::pair<iterator, iterator> >::type
+		equal_range( const K& key ) const {
+			return ft::pair<iterator, iterator>(_tree.lowerBound(key), _tree.upperBound(key));
+		}
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value && !std::is_convertible<K, iterator>::value, size_type>::type
+		erase( const K& key ) {
+			typename tree_type::iterator pos = _tree.find(key);
+
+			if (pos == _tree.end()) return 0;
+			_tree.erase(pos);
+			return 1;
+		}
+
+		key_compare key_comp() const { return _tree.comp(); }
+		value_compare value_comp() const { return _tree.comp(); }
+
+		friend bool operator== (const IndexSet &lhs, const IndexSet &rhs) { return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin()); }
+		friend bool operator!= (const IndexSet &lhs, const IndexSet &rhs) { return !(lhs == rhs); }
+		friend bool operator< (const IndexSet &lhs, const IndexSet &rhs) { return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); }
+		friend bool operator> (const IndexSet &lhs, const IndexSet &rhs) { return rhs < lhs; }
+		friend bool operator>= (const IndexSet &lhs, const IndexSet &rhs) { return !(lhs < rhs); }
+		friend bool operator<= (const IndexSet &lhs, const IndexSet &rhs) { return !(rhs < lhs); }
+
+	private:
+		typename tree_type::iterator unconst(iterator pos) const {
+			return typename tree_type::iterator(pos.tree(), pos.index());
+		}
+	};
+}
+
+#endif
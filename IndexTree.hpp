@@ -0,0 +1,498 @@
+#pragma once
+#ifndef INDEX_TREE_HPP
+#define INDEX_TREE_HPP
+
+# include <memory>
+# include <cstddef>
+# include <cstdint>
+# include <new>
+# include <stdexcept>
+# include <type_traits>
+# include <utility>
+# include "Iterator.hpp"
+# include "Utility.hpp"
+# include "Vector.hpp"
+
+namespace ft {
+	/*
+	** Red-black tree backing ft::IndexMap and ft::IndexSet. Nodes live in
+	** one ft::Vector and link to each other by 32-bit index, so a node
+	** carries 12 bytes of links instead of ft::Map's 24, and neighbours sit
+	** in one block of memory. Index 0 is the sentinel: every empty subtree
+	** and end(). The colour takes the low bit of the parent link, which caps
+	** the tree at 2^31 - 1 elements. Erased nodes are chained through right
+	** and reused first. As links are indices, a copy copies the array and
+	** fixes nothing up. Growing the array moves the values, so inserting may
+	** invalidate pointers and references into the tree, though not
+	** iterators, which hold an index; swap() does invalidate them.
+	*/
+	template <class Value, class Key, class KeyOfValue, class Compare, class A>
+	class IndexTree {
+	public:
+		typedef std::size_t									size_type;
+		typedef std::uint32_t								index_type;
+		typedef ft::IndexIterator<IndexTree, Value>			iterator;
+		typedef ft::IndexIterator<IndexTree, const Value>	const_iterator;
+
+	private:
+		/* left holds Dead while the node holds no value: the sentinel and
+		** the nodes on the free list. */
+		static const index_type	Dead = 0xFFFFFFFFu;
+		static const size_type	MaxNodes = 0x7FFFFFFFu;
+
+		struct Node_ {
+			index_type	left;
+			index_type	right;
+			index_type	parent;
+			typename std::aligned_storage<sizeof(Value), std::alignment_of<Value>::value>::type	storage;
+
+			Node_(): left(Dead), right(Dead), parent(0) {}
+			Node_(const Node_& other): left(other.left), right(other.right), parent(other.parent) {
+				if (other.live()) new (&storage) Value(other.value());
+			}
+			Node_(Node_&& other) noexcept(std::is_nothrow_move_constructible<Value>::value)
+				: left(other.left), right(other.right), parent(other.parent) {
+				if (other.live()) new (&storage) Value(std::move(other.value()));
+			}
+			~Node_() { if (live()) value().~Value(); }
+
+			bool			live() const	{ return left != Dead; }
+			Value&			value()			{ return *reinterpret_cast<Value*>(&storage); }
+			const Value&	value() const	{ return *reinterpret_cast<const Value*>(&storage); }
+
+		private:
+			Node_& operator=(const Node_& other);
+		};
+
+		typedef typename A::template rebind<Node_>::other	allocator_node;
+
+		ft::Vector<Node_, allocator_node>	_nodes;
+		Compare								_comp;
+		KeyOfValue							_key;
+		index_type							_root;
+		index_type							_first;
+		index_type							_last;
+		index_type							_free;
+		size_type							_size;
+
+	public:
+		/**************************** Constructors ****************************/
+		explicit IndexTree(const Compare& comp = Compare(), const A& alloc = A())
+			: _nodes(allocator_node(alloc)), _comp(comp), _root(0), _first(0), _last(0), _free(0), _size(0) {
+			_nodes.emplace_back();
+		}
+
+		IndexTree(const IndexTree& other)
+			: _nodes(other._nodes), _comp(other._comp), _root(other._root), _first(other._first),
+			_last(other._last), _free(other._free), _size(other._size) {}
+
+		IndexTree& operator=(const IndexTree& other) {
+			if (this == &other)
+				return *this;
+			IndexTree tmp(other);
+			swap(tmp);
+			return *this;
+		}
+
+		~IndexTree() {}
+
+		/*************************** Members Methods **************************/
+		iterator		begin()			{ return iterator(this, _first); }
+		const_iterator	begin() const	{ return const_iterator(this, _first); }
+		iterator		end()			{ return iterator(this, 0); }
+		const_iterator	end() const		{ return const_iterator(this, 0); }
+		size_type		size() const	{ return _size; }
+		size_type		max_size() const	{ return MaxNodes; }
+		Compare			comp() const	{ return _comp; }
+
+		/* Room for count elements without moving the array. */
+		void reserve(size_type count)	{ _nodes.reserve(count + 1); }
+
+		void clear() {
+			_nodes.clear();
+			_nodes.emplace_back();
+			_root = _first = _last = _free = 0;
+			_size = 0;
+		}
+
+		void swap(IndexTree& other) {
+			_nodes.swap(other._nodes);
+			std::swap(_comp, other._comp);
+			std::swap(_root, other._root);
+			std::swap(_first, other._first);
+			std::swap(_last, other._last);
+			std::swap(_free, other._free);
+			std::swap(_size, other._size);
+		}
+
+		/* In-order neighbours, for the iterators; from end() next wraps to the
+		** first element and prev to the last. */
+		index_type next(index_type i) const {
+			index_type p;
+
+			if (!i) return _first;
+			if (node(i).right) return leftmost(node(i).right);
+			for (p = parentOf(i); p && i == node(p).right; p = parentOf(p))
+				i = p;
+			return p;
+		}
+
+		index_type prev(index_type i) const {
+			index_type p;
+
+			if (!i) return _last;
+			if (node(i).left) return rightmost(node(i).left);
+			for (p = parentOf(i); p && i == node(p).left; p = parentOf(p))
+				i = p;
+			return p;
+		}
+
+		Value& value(index_type i) const { return const_cast<Node_&>(node(i)).value(); }
+
+		template <class K>
+		iterator lowerBound(const K& key) const {
+			index_type x = _root, y = 0;
+
+			while (x) {
+				if (_comp(_key(node(x).value()), key)) {
+					x = node(x).right;
+				} else {
+					y = x;
+					x = node(x).left;
+				}
+			}
+			return iterator(this, y);
+		}
+
+		template <class K>
+		iterator upperBound(const K& key) const {
+			index_type x = _root, y = 0;
+
+			while (x) {
+				if (_comp(key, _key(node(x).value()))) {
+					y = x;
+					x = node(x).left;
+				} else {
+					x = node(x).right;
+				}
+			}
+			return iterator(this, y);
+		}
+
+		template <class K>
+		iterator find(const K& key) const {
+			iterator pos = lowerBound(key);
+
+			if (!pos.index() || _comp(key, _key(node(pos.index()).value())))
+				return iterator(this, 0);
+			return pos;
+		}
+
+		ft::pair<iterator, bool> insertUnique(const Value& value) {
+			index_type x = _root, parent = 0;
+			bool left = true;
+
+			while (x) {
+				parent = x;
+				if (_comp(_key(value), _key(node(x).value()))) {
+					left = true;
+					x = node(x).left;
+				} else if (_comp(_key(node(x).value()), _key(value))) {
+					left = false;
+					x = node(x).right;
+				} else {
+					return ft::make_pair(iterator(this, x), false);
+				}
+			}
+			return ft::make_pair(iterator(this, attach(parent, left, value)), true);
+		}
+
+		/* Links value in next to hint when it belongs right before it, or
+		** after the last element; anything else goes through the root. */
+		iterator insertHint(iterator hint, const Value& value) {
+			index_type pos = hint.index(), before;
+
+			if (!pos) {
+				if (_size && _comp(_key(node(_last).value()), _key(value)))
+					return iterator(this, attach(_last, false, value));
+			} else if (_comp(_key(value), _key(node(pos).value()))) {
+				if (pos == _first)
+					return iterator(this, attach(pos, true, value));
+				before = prev(pos);
+				if (_comp(_key(node(before).value()), _key(value)))
+					return iterator(this, node(pos).left ? attach(before, false, value) : attach(pos, true, value));
+			}
+			return insertUnique(value).first;
+		}
+
+		/* Returns the element that followed the erased one. Erasing relinks
+		** nodes and moves no value, so other iterators stay valid. */
+		iterator erase(iterator pos) {
+			index_type z = pos.index(), after = next(z);
+
+			unlinkNode(z);
+			freeNode(z);
+			return iterator(this, after);
+		}
+
+		void erase(iterator first, iterator last) {
+			if (first == begin() && last == end())
+				return clear();
+			while (first != last)
+				first = erase(first);
+		}
+
+	private:
+		/****************************** Nodes ******************************/
+		Node_&			node(index_type i)			{ return _nodes[i]; }
+		const Node_&	node(index_type i) const	{ return _nodes[i]; }
+		index_type		parentOf(index_type i) const	{ return node(i).parent >> 1; }
+		bool			red(index_type i) const			{ return node(i).parent & 1; }
+		void			setParent(index_type i, index_type p)	{ node(i).parent = (p << 1) | (node(i).parent & 1); }
+		void			setRed(index_type i, bool r)			{ node(i).parent = (node(i).parent & ~1u) | r; }
+
+		index_type leftmost(index_type x) const {
+			while (node(x).left)
+				x = node(x).left;
+			return x;
+		}
+
+		index_type rightmost(index_type x) const {
+			while (node(x).right)
+				x = node(x).right;
+			return x;
+		}
+
+		/* A node off the free list, else a new one at the end of the array. */
+		index_type allocateNode(const Value& value) {
+			index_type x = _free;
+
+			if (x) {
+				new (&node(x).storage) Value(value);
+				_free = node(x).right;
+			} else {
+				if (_nodes.size() > MaxNodes)
+					throw std::length_error("IndexTree");
+				_nodes.emplace_back();
+				x = static_cast<index_type>(_nodes.size() - 1);
+				try {
+					new (&node(x).storage) Value(value);
+				} catch (...) {
+					_nodes.pop_back();
+					throw;
+				}
+			}
+			node(x).left = node(x).right = 0;
+			return x;
+		}
+
+		void freeNode(index_type x) {
+			node(x).value().~Value();
+			node(x).left = Dead;
+			node(x).right = _free;
+			_free = x;
+		}
+
+		/***************************** Balance ******************************/
+		/* Hangs a new node for value under parent, or makes it the root. */
+		index_type attach(index_type parent, bool left, const Value& value) {
+			index_type x = allocateNode(value);
+
+			node(x).parent = (parent << 1) | 1;
+			if (!parent) {
+				_root = _first = _last = x;
+			} else if (left) {
+				node(parent).left = x;
+				if (parent == _first) _first = x;
+			} else {
+				node(parent).right = x;
+				if (parent == _last) _last = x;
+			}
+			insertFixup(x);
+			++_size;
+			return x;
+		}
+
+		void rotateLeft(index_type x) {
+			index_type y = node(x).right, p = parentOf(x);
+
+			node(x).right = node(y).left;
+			if (node(y).left) setParent(node(y).left, x);
+			setParent(y, p);
+			if (!p)
+				_root = y;
+			else if (x == node(p).left)
+				node(p).left = y;
+			else
+				node(p).right = y;
+			node(y).left = x;
+			setParent(x, y);
+		}
+
+		void rotateRight(index_type x) {
+			index_type y = node(x).left, p = parentOf(x);
+
+			node(x).left = node(y).right;
+			if (node(y).right) setParent(node(y).right, x);
+			setParent(y, p);
+			if (!p)
+				_root = y;
+			else if (x == node(p).right)
+				node(p).right = y;
+			else
+				node(p).left = y;
+			node(y).right = x;
+			setParent(x, y);
+		}
+
+		void insertFixup(index_type x) {
+			while (x != _root && red(parentOf(x))) {
+				index_type p = parentOf(x), g = parentOf(p), y;
+
+				if (p == node(g).left) {
+					y = node(g).right;
+					if (red(y)) {
+						setRed(p, false);
+						setRed(y, false);
+						setRed(g, true);
+						x = g;
+					} else {
+						if (x == node(p).right) {
+							x = p;
+							rotateLeft(x);
+							p = parentOf(x);
+						}
+						setRed(p, false);
+						setRed(g, true);
+						rotateRight(g);
+					}
+				} else {
+					y = node(g).left;
+					if (red(y)) {
+						setRed(p, false);
+						setRed(y, false);
+						setRed(g, true);
+						x = g;
+					} else {
+						if (x == node(p).left) {
+							x = p;
+							rotateRight(x);
+							p = parentOf(x);
+						}
+						setRed(p, false);
+						setRed(g, true);
+						rotateLeft(g);
+					}
+				}
+			}
+			setRed(_root, false);
+		}
+
+		/* x may be the sentinel, whose parent link the caller set. */
+		void deleteFixup(index_type x) {
+			while (x != _root && !red(x)) {
+				index_type p = parentOf(x), w;
+
+				if (x == node(p).left) {
+					w = node(p).right;
+					if (red(w)) {
+						setRed(w, false);
+						setRed(p, true);
+						rotateLeft(p);
+						w = node(p).right;
+					}
+					if (!red(node(w).left) && !red(node(w).right)) {
+						setRed(w, true);
+						x = p;
+					} else {
+						if (!red(node(w).right)) {
+							setRed(node(w).left, false);
+							setRed(w, true);
+							rotateRight(w);
+							w = node(p).right;
+						}
+						setRed(w, red(p));
+						setRed(p, false);
+						setRed(node(w).right, false);
+						rotateLeft(p);
+						x = _root;
+					}
+				} else {
+					w = node(p).left;
+					if (red(w)) {
+						setRed(w, false);
+						setRed(p, true);
+						rotateRight(p);
+						w = node(p).left;
+					}
+					if (!red(node(w).right) && !red(node(w).left)) {
+						setRed(w, true);
+						x = p;
+					} else {
+						if (!red(node(w).left)) {
+							setRed(node(w).right, false);
+							setRed(w, true);
+							rotateLeft(w);
+							w = node(p).left;
+						}
+						setRed(w, red(p));
+						setRed(p, false);
+						setRed(node(w).left, false);
+						rotateRight(p);
+						x = _root;
+					}
+				}
+			}
+			setRed(x, false);
+		}
+
+		void transplant(index_type u, index_type v) {
+			index_type p = parentOf(u);
+
+			if (!p)
+				_root = v;
+			else if (u == node(p).left)
+				node(p).left = v;
+			else
+				node(p).right = v;
+			setParent(v, p);
+		}
+
+		/* With two children z's successor y is spliced into its place, so
+		** no value moves and every other index stays put. */
+		void unlinkNode(index_type z) {
+			index_type x, y;
+			bool wasRed = red(z);
+
+			if (z == _first) _first = next(z);
+			if (z == _last) _last = prev(z);
+			if (!node(z).left) {
+				x = node(z).right;
+				transplant(z, x);
+			} else if (!node(z).right) {
+				x = node(z).left;
+				transplant(z, x);
+			} else {
+				y = leftmost(node(z).right);
+				wasRed = red(y);
+				x = node(y).right;
+				if (parentOf(y) == z) {
+					setParent(x, y);
+				} else {
+					transplant(y, x);
+					node(y).right = node(z).right;
+					setParent(node(y).right, y);
+				}
+				transplant(z, y);
+				node(y).left = node(z).left;
+				setParent(node(y).left, y);
+				setRed(y, red(z));
+			}
+			if (!wasRed)
+				deleteFixup(x);
+			--_size;
+		}
+	};
+}
+
+#endif
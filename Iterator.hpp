@@ -3,6 +3,9 @@
 #define ITERATOR_HPP
 
 # include <cstddef>
+# include <cstdint>
+# include <iterator>
+# include <type_traits>
 # include "Utility.hpp"
 
 namespace ft {
@@ -43,6 +46,7 @@ namespace ft {
 		typedef typename IteratorTraits<Iterator>::iterator_category	iterator_category;
 		/**************************** Constructors ****************************/
 		WrapIterator(Iterator wrap = NULL): _wrap(wrap) {}
+		WrapIterator(const WrapIterator& other): _wrap(other.base()) {}
 		~WrapIterator() {}
 
 		template <class W>
@@ -84,13 +88,24 @@ namespace ft {
 	class NodeIterator {
 	private:
 		Iterator	_node;
+		typedef ft::has_thread_links<typename std::remove_pointer<Iterator>::type>	threaded_;
 		/*********************** Next and Previous **********************/
-		void	next() {
-			if (_node->NIL && _node->begin != _node) {
-				_node = _node->begin;
-			} else if (!_node->right->NIL) {
+		/* Threaded trees link each node to its neighbours in key order. */
+		void	next()									{ next(threaded_()); }
+		void	prev()									{ prev(threaded_()); }
+		void	next(ft::integral_constant<bool, true>)	{ _node = static_cast<Iterator>(_node->succ); }
+		void	prev(ft::integral_constant<bool, true>)	{ _node = static_cast<Iterator>(_node->pred); }
+
+		void	next(ft::integral_constant<bool, false>) {
+			if (_node->isNil() && _node->parent != _node) {
+				/* Past the end wraps to the first node, reached from the last. */
+				for (_node = _node->parent; _node->parent; )
+					_node = _node->parent;
+				while (!_node->left->isNil())
+					_node = _node->left;
+			} else if (!_node->right->isNil()) {
 				_node = _node->right;
-				while (!_node->left->NIL)
+				while (!_node->left->isNil())
 					_node = _node->left;
 			} else {
 				Iterator tmp = _node;
@@ -111,12 +126,12 @@ namespace ft {
 			}
 		}
 
-		void	prev() {
-			if (_node->NIL) {
+		void	prev(ft::integral_constant<bool, false>) {
+			if (_node->isNil()) {
 				_node = _node->parent;
-			} else if (!_node->left->NIL) {
+			} else if (!_node->left->isNil()) {
 				_node = _node->left;
-				while (!_node->right->NIL)
+				while (!_node->right->isNil())
 					_node = _node->right;
 			} else {
 				Iterator tmp = _node;
@@ -144,6 +159,7 @@ namespace ft {
 		iterator_type base() const					{ return _node; }
 		/**************************** Constructors ****************************/
 		NodeIterator(Iterator node = NULL): _node(node) {}
+		NodeIterator(const NodeIterator& other): _node(other.base()) {}
 		~NodeIterator() {}
 
 		template <class N, class Z>
@@ -162,18 +178,441 @@ namespace ft {
 		NodeIterator	&operator++() 									{ next(); return *this; }
 		NodeIterator	operator--(int)									{ NodeIterator tmp(*this); prev(); return tmp; }
 		NodeIterator	&operator--() 									{ prev(); return *this; }
-		reference 		operator*()		 								{ return *(_node->pair); }
-		const_reference operator*() const								{ return *(_node->pair); }
-		pointer 		operator->()									{ return _node->pair; }
-		const_pointer 	operator->() const								{ return _node->pair; }
+
+		/* O(log n) jumps through subtree sizes; only for ft::OrderStatistics trees. */
+		template <class I = Iterator>
+		typename ft::enable_if<ft::has_subtree_count<typename std::remove_pointer<I>::type>::value, NodeIterator&>::type
+		operator+=(difference_type n) {
+			typedef typename std::remove_const<typename std::remove_pointer<I>::type>::type	node_type;
+
+			_node = node_type::select(_node, (difference_type)node_type::rank(_node) + n);
+			return *this;
+		}
+
+		template <class I = Iterator>
+		typename ft::enable_if<ft::has_subtree_count<typename std::remove_pointer<I>::type>::value, NodeIterator&>::type
+		operator-=(difference_type n)									{ return *this += -n; }
+
+		template <class I = Iterator>
+		typename ft::enable_if<ft::has_subtree_count<typename std::remove_pointer<I>::type>::value, NodeIterator>::type
+		operator+(difference_type n) const								{ NodeIterator tmp(*this); return tmp += n; }
+
+		template <class I = Iterator>
+		typename ft::enable_if<ft::has_subtree_count<typename std::remove_pointer<I>::type>::value, NodeIterator>::type
+		operator-(difference_type n) const								{ NodeIterator tmp(*this); return tmp += -n; }
+		reference 		operator*()		 								{ return _node->pair; }
+		const_reference operator*() const								{ return _node->pair; }
+		pointer 		operator->()									{ return &_node->pair; }
+		const_pointer 	operator->() const								{ return &_node->pair; }
 		bool			operator==(NodeIterator const &other) const 	{ return _node == other._node; }
 		bool			operator!=(NodeIterator const &other) const 	{ return _node != other._node; }
-		bool 			operator>(NodeIterator const &other) const 		{ return _node->pair > other._node->pair; }
-		bool 			operator<(NodeIterator const &other) const 		{ return other._node->pair > _node->pair; }
-		bool 			operator<=(NodeIterator const &other) const 	{ return _node->pair <= other._node->pair; }
-		bool 			operator>=(NodeIterator const &other) const 	{ return _node->pair >= other._node->pair; }
+		bool 			operator>(NodeIterator const &other) const 		{ return &_node->pair > &other._node->pair; }
+		bool 			operator<(NodeIterator const &other) const 		{ return &other._node->pair > &_node->pair; }
+		bool 			operator<=(NodeIterator const &other) const 	{ return &_node->pair <= &other._node->pair; }
+		bool 			operator>=(NodeIterator const &other) const 	{ return &_node->pair >= &other._node->pair; }
+	};
+
+	/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<< BTREE ITERATOR >>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+	template <class Leaf, class Value>
+	class BTreeIterator {
+		Leaf			*_leaf;
+		unsigned short	_index;
+	public:
+		typedef typename std::remove_const<Value>::type	value_type;
+		typedef ptrdiff_t								difference_type;
+		typedef Value&									reference;
+		typedef const Value&							const_reference;
+		typedef Value*									pointer;
+		typedef const Value*							const_pointer;
+		typedef std::bidirectional_iterator_tag			iterator_category;
+
+		Leaf*			leaf() const	{ return _leaf; }
+		unsigned short	index() const	{ return _index; }
+		/**************************** Constructors ****************************/
+		BTreeIterator(Leaf *leaf = NULL, unsigned short index = 0): _leaf(leaf), _index(index) {}
+		~BTreeIterator() {}
+
+		template <class V>
+		BTreeIterator(BTreeIterator<Leaf, V> const& other,
+					typename ft::enable_if<std::is_convertible<V*, Value*>::value>::type* = 0)
+					: _leaf(other.leaf()), _index(other.index()) {}
+
+		/************************ Operator overloading ************************/
+		/* Stepping back from the first element parks the iterator one slot
+		** before it, which is what rend() points at. */
+		BTreeIterator&	operator++() {
+			if (++_index == _leaf->count && _leaf->next) {
+				_leaf = _leaf->next;
+				_index = 0;
+			}
+			return *this;
+		}
+		BTreeIterator&	operator--() {
+			if (_index == 0 && _leaf->prev) {
+				_leaf = _leaf->prev;
+				_index = _leaf->count;
+			}
+			--_index;
+			return *this;
+		}
+		BTreeIterator	operator++(int)									{ BTreeIterator tmp(*this); ++(*this); return tmp; }
+		BTreeIterator	operator--(int)									{ BTreeIterator tmp(*this); --(*this); return tmp; }
+		reference		operator*() const								{ return _leaf->values()[_index]; }
+		pointer			operator->() const								{ return _leaf->values() + _index; }
+		bool			operator==(BTreeIterator const &other) const	{ return _leaf == other._leaf && _index == other._index; }
+		bool			operator!=(BTreeIterator const &other) const	{ return !(*this == other); }
+	};
+
+	/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<< INDEX ITERATOR >>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+	/* Holds the tree and a node index rather than a node address, so it
+	** stays valid while the node array grows. Index 0 is end(). */
+	template <class Tree, class Value>
+	class IndexIterator {
+		const Tree		*_tree;
+		std::uint32_t	_index;
+	public:
+		typedef typename std::remove_const<Value>::type	value_type;
+		typedef ptrdiff_t								difference_type;
+		typedef Value&									reference;
+		typedef const Value&							const_reference;
+		typedef Value*									pointer;
+		typedef const Value*							const_pointer;
+		typedef std::bidirectional_iterator_tag			iterator_category;
+
+		const Tree*		tree() const	{ return _tree; }
+		std::uint32_t	index() const	{ return _index; }
+		/**************************** Constructors ****************************/
+		IndexIterator(const Tree *tree = NULL, std::uint32_t index = 0): _tree(tree), _index(index) {}
+		~IndexIterator() {}
+
+		template <class V>
+		IndexIterator(IndexIterator<Tree, V> const& other,
+					typename ft::enable_if<std::is_convertible<V*, Value*>::value>::type* = 0)
+					: _tree(other.tree()), _index(other.index()) {}
+
+		/************************ Operator overloading ************************/
+		IndexIterator&	operator++()									{ _index = _tree->next(_index); return *this; }
+		IndexIterator&	operator--()									{ _index = _tree->prev(_index); return *this; }
+		IndexIterator	operator++(int)									{ IndexIterator tmp(*this); ++(*this); return tmp; }
+		IndexIterator	operator--(int)									{ IndexIterator tmp(*this); --(*this); return tmp; }
+		reference		operator*() const								{ return _tree->value(_index); }
+		pointer			operator->() const								{ return &_tree->value(_index); }
+		bool			operator==(IndexIterator const &other) const	{ return _index == other._index && _tree == other._tree; }
+		bool			operator!=(IndexIterator const &other) const	{ return !(*this == other); }
 	};
-	
+
+	/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<< HASH ITERATOR >>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+	template <class Value>
+	class HashIterator {
+		Value				*_slot;
+		const unsigned char	*_dist;
+	public:
+		typedef typename std::remove_const<Value>::type	value_type;
+		typedef ptrdiff_t								difference_type;
+		typedef Value&									reference;
+		typedef const Value&							const_reference;
+		typedef Value*									pointer;
+		typedef const Value*							const_pointer;
+		typedef std::forward_iterator_tag				iterator_category;
+
+		Value*					slot() const	{ return _slot; }
+		const unsigned char*	dist() const	{ return _dist; }
+		/**************************** Constructors ****************************/
+		HashIterator(Value *slot = NULL, const unsigned char *dist = NULL): _slot(slot), _dist(dist) {}
+		~HashIterator() {}
+
+		template <class V>
+		HashIterator(HashIterator<V> const& other,
+					typename ft::enable_if<std::is_convertible<V*, Value*>::value>::type* = 0)
+					: _slot(other.slot()), _dist(other.dist()) {}
+
+		/************************ Operator overloading ************************/
+		/* Skips empty slots; the table's trailing non-zero byte stops the scan. */
+		HashIterator&	operator++()									{ do { ++_slot; ++_dist; } while (!*_dist); return *this; }
+		HashIterator	operator++(int)									{ HashIterator tmp(*this); ++(*this); return tmp; }
+		reference		operator*() const								{ return *_slot; }
+		pointer			operator->() const								{ return _slot; }
+		bool			operator==(HashIterator const &other) const		{ return _slot == other._slot; }
+		bool			operator!=(HashIterator const &other) const		{ return _slot != other._slot; }
+	};
+
+	/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<< SKIP ITERATOR >>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+	/* Walks the bottom level of a concurrent skip list and steps over nodes
+	** that are half inserted or already erased. The Guard it carries keeps
+	** its thread pinned, so the node under it is never freed. */
+	template <class Node, class Value, class Guard>
+	class SkipIterator {
+		Node	*_node;
+		Guard	_guard;
+	public:
+		typedef typename std::remove_const<Value>::type	value_type;
+		typedef ptrdiff_t								difference_type;
+		typedef Value&									reference;
+		typedef const Value&							const_reference;
+		typedef Value*									pointer;
+		typedef const Value*							const_pointer;
+		typedef std::forward_iterator_tag				iterator_category;
+
+		Node*			node() const	{ return _node; }
+		const Guard&	guard() const	{ return _guard; }
+		/**************************** Constructors ****************************/
+		SkipIterator(): _node(NULL) {}
+		SkipIterator(Node *node, const Guard& guard): _node(node), _guard(guard) {}
+		~SkipIterator() {}
+
+		template <class V>
+		SkipIterator(SkipIterator<Node, V, Guard> const& other,
+					typename ft::enable_if<std::is_convertible<V*, Value*>::value>::type* = 0)
+					: _node(other.node()), _guard(other.guard()) {}
+
+		/************************ Operator overloading ************************/
+		SkipIterator&	operator++()									{ _node = Node::nextLive(_node); return *this; }
+		SkipIterator	operator++(int)									{ SkipIterator tmp(*this); ++(*this); return tmp; }
+		reference		operator*() const								{ return _node->value(); }
+		pointer			operator->() const								{ return &_node->value(); }
+		bool			operator==(SkipIterator const &other) const		{ return _node == other._node; }
+		bool			operator!=(SkipIterator const &other) const		{ return _node != other._node; }
+	};
+
+	/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<< PATH ITERATOR >>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+	/* In-order walk of a tree without parent links, as persistent trees share
+	** subtrees and so cannot have them: the iterator keeps the ancestors it
+	** still has to visit, the current node on top, and an empty stack is end. */
+	template <class Node, class Value, std::size_t Depth>
+	class PathIterator {
+		Node		*_path[Depth];
+		std::size_t	_depth;
+	public:
+		typedef typename std::remove_const<Value>::type	value_type;
+		typedef ptrdiff_t								difference_type;
+		typedef Value&									reference;
+		typedef const Value&							const_reference;
+		typedef Value*									pointer;
+		typedef const Value*							const_pointer;
+		typedef std::forward_iterator_tag				iterator_category;
+
+		Node*	node() const	{ return _depth ? _path[_depth - 1] : NULL; }
+		/**************************** Constructors ****************************/
+		PathIterator(): _depth(0) {}
+		PathIterator(const PathIterator& other): _depth(other._depth) {
+			for (std::size_t i = 0; i < _depth; ++i)
+				_path[i] = other._path[i];
+		}
+		~PathIterator() {}
+
+		PathIterator& operator=(const PathIterator& other) {
+			if (this == &other)
+				return *this;
+			_depth = other._depth;
+			for (std::size_t i = 0; i < _depth; ++i)
+				_path[i] = other._path[i];
+			return *this;
+		}
+
+		/* Builders: push() for a node whose left subtree is walked before it,
+		** pushLeftmost() for the whole left spine of a subtree. */
+		void	push(Node *x)			{ _path[_depth++] = x; }
+		void	pushLeftmost(Node *x)	{ for ( ; x; x = x->left) push(x); }
+
+		/************************ Operator overloading ************************/
+		PathIterator&	operator++()									{ pushLeftmost(_path[--_depth]->right); return *this; }
+		PathIterator	operator++(int)									{ PathIterator tmp(*this); ++(*this); return tmp; }
+		reference		operator*() const								{ return node()->value(); }
+		pointer			operator->() const								{ return &node()->value(); }
+		bool			operator==(PathIterator const &other) const		{ return node() == other.node(); }
+		bool			operator!=(PathIterator const &other) const		{ return node() != other.node(); }
+	};
+
+	/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<< MERGE ITERATOR >>>>>>>>>>>>>>>>>>>>>>>>>>*/
+	/* Walks N sorted ranges of pairs with disjoint keys as one: a min-heap of
+	** range indices, ordered by the key under each cursor, picks the next
+	** element in O(log N). Exhausted ranges leave the heap. */
+	template <class Iterator, class Compare, std::size_t N>
+	class MergeIterator {
+		Iterator	_cur[N];
+		Iterator	_end[N];
+		std::size_t	_heap[N];
+		std::size_t	_live;
+		Compare		_comp;
+	public:
+		typedef typename Iterator::value_type			value_type;
+		typedef typename Iterator::difference_type		difference_type;
+		typedef typename Iterator::reference			reference;
+		typedef typename Iterator::pointer				pointer;
+		typedef std::forward_iterator_tag				iterator_category;
+
+		const Iterator&	cursor(std::size_t i) const	{ return _cur[i]; }
+		const Iterator&	last(std::size_t i) const	{ return _end[i]; }
+		const Compare&	comp() const				{ return _comp; }
+		/**************************** Constructors ****************************/
+		MergeIterator(): _live(0) {}
+		MergeIterator(const Iterator *first, const Iterator *last, const Compare& comp): _live(0), _comp(comp) {
+			for (std::size_t i = 0; i < N; ++i) {
+				_cur[i] = first[i];
+				_end[i] = last[i];
+			}
+			makeHeap();
+		}
+		~MergeIterator() {}
+
+		template <class It>
+		MergeIterator(MergeIterator<It, Compare, N> const& other,
+					typename ft::enable_if<std::is_convertible<It, Iterator>::value>::type* = 0)
+					: _live(0), _comp(other.comp()) {
+			for (std::size_t i = 0; i < N; ++i) {
+				_cur[i] = other.cursor(i);
+				_end[i] = other.last(i);
+			}
+			makeHeap();
+		}
+
+		/************************ Operator overloading ************************/
+		MergeIterator&	operator++() {
+			std::size_t top = _heap[0];
+
+			if (++_cur[top] == _end[top])
+				_heap[0] = _heap[--_live];
+			siftDown(0);
+			return *this;
+		}
+		MergeIterator	operator++(int)									{ MergeIterator tmp(*this); ++(*this); return tmp; }
+		reference		operator*() const								{ return *head(); }
+		pointer			operator->() const								{ return &*head(); }
+		bool			operator!=(MergeIterator const &other) const	{ return !(*this == other); }
+
+		/* Every live cursor is past the elements already seen, so two
+		** iterators over the same ranges agree once their heads do. */
+		bool operator==(MergeIterator const &other) const {
+			if (_live != other._live) return false;
+			return !_live || (_heap[0] == other._heap[0] && _cur[_heap[0]] == other._cur[other._heap[0]]);
+		}
+
+	private:
+		/* A copy, since node iterators only hand out const elements when const. */
+		Iterator	head() const							{ return _cur[_heap[0]]; }
+		bool		before(std::size_t a, std::size_t b) const	{ return _comp(_cur[a]->first, _cur[b]->first); }
+
+		void makeHeap() {
+			for (std::size_t i = 0; i < N; ++i)
+				if (_cur[i] != _end[i])
+					_heap[_live++] = i;
+			for (std::size_t i = _live / 2; i-- > 0; )
+				siftDown(i);
+		}
+
+		void siftDown(std::size_t i) {
+			for (std::size_t child; (child = 2 * i + 1) < _live; i = child) {
+				if (child + 1 < _live && before(_heap[child + 1], _heap[child]))
+					++child;
+				if (!before(_heap[child], _heap[i]))
+					break;
+				std::swap(_heap[i], _heap[child]);
+			}
+		}
+	};
+
+	/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<< FLAT ITERATOR >>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+	template <class Key, class T>
+	class FlatIterator {
+		const Key	*_key;
+		T			*_value;
+	public:
+		typedef ft::pair<const Key, typename std::remove_const<T>::type>	value_type;
+		typedef ft::pair<const Key&, T&>									reference;
+		typedef ft::pair<const Key&, const T&>								const_reference;
+		typedef std::ptrdiff_t												difference_type;
+		typedef std::random_access_iterator_tag								iterator_category;
+
+		/* Keys and values are stored apart, so -> hands out a pair of references. */
+		class pointer {
+			reference	_ref;
+		public:
+			pointer(const reference& ref): _ref(ref) {}
+			reference*	operator->() { return &_ref; }
+		};
+		typedef pointer														const_pointer;
+
+		const Key*	keyBase() const		{ return _key; }
+		T*			valueBase() const	{ return _value; }
+		/**************************** Constructors ****************************/
+		FlatIterator(const Key *key = NULL, T *value = NULL): _key(key), _value(value) {}
+		~FlatIterator() {}
+
+		template <class U>
+		FlatIterator(const FlatIterator<Key, U>& other,
+					typename ft::enable_if<std::is_convertible<U*, T*>::value>::type* = 0)
+					: _key(other.keyBase()), _value(other.valueBase()) {}
+
+		/************************ Operator overloading ************************/
+		FlatIterator&	operator++()									{ ++_key; ++_value; return *this; }
+		FlatIterator	operator++(int)									{ FlatIterator tmp(*this); ++(*this); return tmp; }
+		FlatIterator&	operator--()									{ --_key; --_value; return *this; }
+		FlatIterator	operator--(int)									{ FlatIterator tmp(*this); --(*this); return tmp; }
+		FlatIterator	operator+(difference_type n) const				{ return FlatIterator(_key + n, _value + n); }
+		FlatIterator	operator-(difference_type n) const				{ return FlatIterator(_key - n, _value - n); }
+		difference_type	operator-(FlatIterator const& other) const		{ return _key - other._key; }
+		FlatIterator&	operator+=(difference_type n)					{ _key += n; _value += n; return *this; }
+		FlatIterator&	operator-=(difference_type n)					{ _key -= n; _value -= n; return *this; }
+		reference		operator*() const								{ return reference(*_key, *_value); }
+		pointer			operator->() const								{ return pointer(**this); }
+		reference		operator[](difference_type n) const				{ return *(*this + n); }
+		bool			operator==(FlatIterator const& other) const		{ return _key == other._key; }
+		bool			operator!=(FlatIterator const& other) const		{ return _key != other._key; }
+		bool			operator<(FlatIterator const& other) const		{ return _key < other._key; }
+		bool			operator>(FlatIterator const& other) const		{ return _key > other._key; }
+		bool			operator<=(FlatIterator const& other) const		{ return _key <= other._key; }
+		bool			operator>=(FlatIterator const& other) const		{ return _key >= other._key; }
+	};
+
+	/*<<<<<<<<<<<<<<<<<<<<<<<<<< FLAT REVERSE ITERATOR >>>>>>>>>>>>>>>>>>>>>>>*/
+	/* Reverse iterator over the flat containers, kept like
+	** std::reverse_iterator: it holds the position after the element it stands
+	** for, so rend() is begin() and nothing ever points before the first
+	** element, even in an empty container. */
+	template <class Iterator>
+	class FlatReverseIterator {
+		Iterator	_base;
+
+	public:
+		typedef Iterator												iterator_type;
+		typedef typename IteratorTraits<Iterator>::difference_type		difference_type;
+		typedef typename IteratorTraits<Iterator>::value_type			value_type;
+		typedef typename IteratorTraits<Iterator>::reference			reference;
+		typedef typename IteratorTraits<Iterator>::const_reference		const_reference;
+		typedef typename IteratorTraits<Iterator>::pointer				pointer;
+		typedef typename IteratorTraits<Iterator>::const_pointer		const_pointer;
+		typedef typename IteratorTraits<Iterator>::iterator_category	iterator_category;
+
+		Iterator base() const { return _base; }
+		/**************************** Constructors ****************************/
+		explicit FlatReverseIterator(Iterator base = Iterator()): _base(base) {}
+		~FlatReverseIterator() {}
+
+		template <class R>
+		FlatReverseIterator(const FlatReverseIterator<R>& other,
+				typename ft::enable_if<std::is_convertible<R, Iterator>::value>::type* = 0): _base(other.base()) {}
+
+		/************************ Operator overloading ************************/
+		reference				operator*() const								{ Iterator tmp(_base); return *--tmp; }
+		pointer					operator->() const								{ Iterator tmp(_base); return (--tmp).operator->(); }
+		FlatReverseIterator&	operator++()									{ --_base; return *this; }
+		FlatReverseIterator		operator++(int)									{ FlatReverseIterator tmp(*this); --_base; return tmp; }
+		FlatReverseIterator&	operator--()									{ ++_base; return *this; }
+		FlatReverseIterator		operator--(int)									{ FlatReverseIterator tmp(*this); ++_base; return tmp; }
+		FlatReverseIterator		operator+(difference_type n) const				{ return FlatReverseIterator(_base - n); }
+		FlatReverseIterator&	operator+=(difference_type n)					{ _base -= n; return *this; }
+		FlatReverseIterator		operator-(difference_type n) const				{ return FlatReverseIterator(_base + n); }
+		FlatReverseIterator&	operator-=(difference_type n)					{ _base += n; return *this; }
+		difference_type			operator-(FlatReverseIterator const& obj) const	{ return obj._base - _base; }
+		reference				operator[](difference_type n) const				{ return *(*this + n); }
+		bool					operator==(FlatReverseIterator const& obj) const	{ return _base == obj._base; }
+		bool					operator!=(FlatReverseIterator const& obj) const	{ return _base != obj._base; }
+		bool					operator<(FlatReverseIterator const& obj) const		{ return _base > obj._base; }
+		bool					operator>(FlatReverseIterator const& obj) const		{ return _base < obj._base; }
+		bool					operator<=(FlatReverseIterator const& obj) const	{ return _base >= obj._base; }
+		bool					operator>=(FlatReverseIterator const& obj) const	{ return _base <= obj._base; }
+	};
+
 	/*<<<<<<<<<<<<<<<<<<<<<<<<<<<< REVERSE ITERATOR >>>>>>>>>>>>>>>>>>>>>>>>>>*/
 	template <class Iterator>
 	class ReverseIterator {
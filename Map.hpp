@@ -4,10 +4,15 @@
 
 # include "Iterator.hpp"
 # include "Node.hpp"
+# include "Pool.hpp"
+# include <limits>
+# include <type_traits>
+# include <utility>
 # include "Utility.hpp"
 
 namespace ft {
-	template <class Key, class T, class Compare = std::less<Key>, class A = std::allocator<std::pair<const Key, T> > >
+	template <class Key, class T, class Compare = std::less<Key>, class A = std::allocator<std::pair<const Key, T> >,
+			class Augment = ft::PlainTree>
 	class Map {
 	public:
 		typedef Key																	key_type;
@@ -21,12 +26,12 @@ namespace ft {
 		typedef const value_type&													const_reference;
 		typedef typename allocator_type::pointer									pointer;
 		typedef typename allocator_type::const_pointer								const_pointer;
-		typedef ft::NodeIterator<Node_<value_type>*, value_type>					iterator;
-		typedef ft::NodeIterator<const Node_<value_type>*, value_type>				const_iterator;
+		typedef ft::NodeIterator<Node_<value_type, Augment>*, value_type>					iterator;
+		typedef ft::NodeIterator<const Node_<value_type, Augment>*, const value_type>				const_iterator;
 		typedef ft::ReverseIterator<iterator>										reverse_iterator;
 		typedef ft::ReverseIterator<const_iterator>								const_reverse_iterator;
-		typedef typename allocator_type::template rebind<Node_<value_type> >::other	allocator_rebind_node;
-		typedef typename allocator_type::template rebind<Tree<value_type> >::other	allocator_rebind_tree;
+		typedef typename allocator_type::template rebind<Node_<value_type, Augment> >::other	allocator_rebind_node;
+		typedef typename allocator_type::template rebind<Tree<value_type, Augment> >::other	allocator_rebind_tree;
 
 		class ValueCompare: public std::binary_function<value_type, value_type, bool> {
 			friend class Map;
@@ -37,38 +42,124 @@ namespace ft {
 			bool operator()(const value_type& _x, const value_type& _y) { return comp(_x.first, _y.second); }
 		};
 
+		/* Owning handle on a node taken out with extract(). It holds a claim on
+		** the node's slab, so it may outlive the map's clear(), move or
+		** destruction. insert() into any map links the node as it is and hands
+		** its slot over to that map's pool. A handle dropped while full destroys
+		** the value and sends the slot back to the pool it was taken from. */
+		class node_type {
+			friend class Map;
+			typedef NodePool<Node_<value_type, Augment>, allocator_rebind_node>	pool_type;
+
+			Node_<value_type, Augment>		*_node;
+			typename pool_type::claim_type	_claim;
+			allocator_rebind_node			_allocator;
+
+			node_type(Node_<value_type, Augment> *x, pool_type& pool, const allocator_rebind_node& alloc)
+				: _node(x), _claim(), _allocator(alloc) {
+				if (x) _claim = pool.take(x);
+			}
+			node_type(const node_type& other);
+			node_type& operator=(const node_type& other);
+
+			Node_<value_type, Augment>* release() {
+				Node_<value_type, Augment> *x = _node;
+
+				_node = 0;
+				return x;
+			}
+
+			void reset() {
+				if (!_node) return;
+				_allocator.destroy(_node);
+				pool_type::drop(release(), _claim, _allocator);
+			}
+
+		public:
+			typedef Key		key_type;
+			typedef T		mapped_type;
+			typedef A		allocator_type;
+
+			/* The key may be changed before the node goes back in. */
+			key_type&		key() const					{ return const_cast<key_type&>(_node->pair.first); }
+			mapped_type&	mapped() const				{ return _node->pair.second; }
+
+			node_type() : _node(0), _claim() {}
+			node_type(node_type&& other) : _node(other._node), _claim(other._claim), _allocator(other._allocator) {
+				other._node = 0;
+			}
+			~node_type() { reset(); }
+
+			node_type& operator=(node_type&& other) {
+				if (this == &other)
+					return *this;
+				reset();
+				_node = other._node;
+				_claim = other._claim;
+				_allocator = other._allocator;
+				other._node = 0;
+				return *this;
+			}
+
+			bool				empty() const				{ return !_node; }
+			explicit			operator bool() const		{ return _node; }
+			allocator_type		get_allocator() const		{ return allocator_type(_allocator); }
+
+			void swap( node_type& other ) {
+				std::swap(_node, other._node);
+				std::swap(_claim, other._claim);
+				std::swap(_allocator, other._allocator);
+			}
+		};
+
+		struct insert_return_type {
+			iterator	position;
+			bool		inserted;
+			node_type	node;
+		};
+
 	private:
+		typedef NodePool<Node_<value_type, Augment>, allocator_rebind_node>	pool_type;
+
 		allocator_type 																_allocator;
 		allocator_rebind_tree														_allocator_rebind_tree;
 		allocator_rebind_node														_allocator_rebind_node;
+		pool_type																	_pool;
 		Compare		 																_comp;
-		Tree<value_type>*															_tree;
+		Tree<value_type, Augment>*															_tree;
 
 	public:
 		/**************************** Constructors ****************************/
 		Map() {
-			_tree = _allocator_rebind_tree.allocate(sizeof(Tree<value_type>));
+			_tree = _allocator_rebind_tree.allocate(1);
 			_allocator_rebind_tree.construct(_tree);
 		}
 
 		explicit Map( const Compare& comp, const A& alloc = A()) : _comp(comp), _allocator(alloc) {
-			_tree = _allocator_rebind_tree.allocate(sizeof(Tree<value_type>));
+			_tree = _allocator_rebind_tree.allocate(1);
 			_allocator_rebind_tree.construct(_tree);
 		}
 
 		template <class InputIt>
 		Map(InputIt first, InputIt last,
 				const Compare& comp = Compare(), const A& alloc = A()) : _allocator(alloc), _comp(comp) {
-			_tree = _allocator_rebind_tree.allocate(sizeof(Tree<value_type>));
+			_tree = _allocator_rebind_tree.allocate(1);
 			_allocator_rebind_tree.construct(_tree);
-			for (; first != last; first++)
-				insert(ft::make_pair(first->first, first->second));
+			insertRange(first, last);
+		}
+
+		template <class InputIt>
+		Map(ft::sorted_unique_t, InputIt first, InputIt last,
+				const Compare& comp = Compare(), const A& alloc = A()) : _allocator(alloc), _comp(comp) {
+			_tree = _allocator_rebind_tree.allocate(1);
+			_allocator_rebind_tree.construct(_tree);
+			buildSorted(first, last);
 		}
 
 		Map(const Map &other) : _allocator(other._allocator), _comp(other._comp) {
-			_tree = _allocator_rebind_tree.allocate(sizeof(Tree<value_type>));
-			_allocator_rebind_tree.construct(_tree, *(other._tree));
-			fillTree(other._tree->root);
+			_tree = _allocator_rebind_tree.allocate(1);
+			_allocator_rebind_tree.construct(_tree);
+			copyTree(*other._tree);
 		}
 
 		Map& operator=(const Map& other) {
@@ -76,10 +167,26 @@ namespace ft {
 				return *this;
 			_comp = other._comp;
 			_allocator = other._allocator;
-			clearMap();
-			_tree = _allocator_rebind_tree.allocate(sizeof(Tree<value_type>));
-			_allocator_rebind_tree.construct(_tree, *other._tree);
-			fillTree(other._tree->root);
+			clear();
+			copyTree(*other._tree);
+			return *this;
+		}
+
+		/* other is left with a fresh empty tree; failing to allocate that one
+		** header is fatal, so containers of maps relocate by move. */
+		Map(Map&& other) noexcept : _allocator(other._allocator), _comp(other._comp) {
+			_tree = _allocator_rebind_tree.allocate(1);
+			_allocator_rebind_tree.construct(_tree);
+			swap(other);
+		}
+
+		Map& operator=(Map&& other) noexcept {
+			if (this == &other)
+				return *this;
+			_comp = other._comp;
+			_allocator = other._allocator;
+			clear();
+			swap(other);
 			return *this;
 		}
 
@@ -93,7 +200,8 @@ namespace ft {
 
 		allocator_type			get_allocator() const 		{ return _allocator; }
 		const T&				at(const Key& key) const	{ return static_cast<const T>(at(key)); }
-		T&						operator[](const Key& key)	{ return insert(ft::make_pair(key, T())).first->second; }
+		T&						operator[](const Key& key)	{ return emplaceKey(key).first->second; }
+		T&						operator[](Key&& key)		{ return emplaceKey(std::move(key)).first->second; }
 		iterator				begin()						{ return _tree->getBegin(); }
 		const_iterator			begin() const				{ return _tree->getBegin(); }
 		iterator				end()						{ return _tree->getEnd(); }
@@ -105,166 +213,345 @@ namespace ft {
 		bool					empty() const				{ return size() == 0; }
 		size_type				size() const				{ return _tree->m_size; }
 		size_type				max_size() const			{ return (std::min((size_type) std::numeric_limits<difference_type>::max(),
-																std::numeric_limits<size_type>::max() / (sizeof(Node_<value_type>) + sizeof(T*)))); }
+																std::numeric_limits<size_type>::max() / sizeof(Node_<value_type, Augment>))); }
 
 		void clear() {
-			clearMap();
-			_tree = _allocator_rebind_tree.allocate(sizeof(Tree<value_type>));
-			_allocator_rebind_tree.construct(_tree);
+			destroyNodes();
+			_tree->reset();
+		}
+
+		void reserve( size_type count ) {
+			if (count > size())
+				_pool.reserve(count - size());
 		}
 
 		pair<iterator, bool> insert(const value_type& value) {
-			return insertNode(_tree->root, value);
+			return insertNode(value);
+		}
+
+		pair<iterator, bool> insert(value_type&& value) {
+			return insertNode(std::move(value));
+		}
+
+		/* emplace builds the value before it can look the key up, and drops it
+		** again when the key is taken; try_emplace and insert_or_assign look
+		** first, so a present key costs no construction. */
+		template <class... Args>
+		pair<iterator, bool> emplace(Args&&... args) {
+			Node_<value_type, Augment> *x = createNode(value_type(std::forward<Args>(args)...)), *parent, *y;
+			bool left;
+
+			if ((y = findSlot(x->pair.first, parent, left))) {
+				destroyNode(x);
+				return ft::make_pair(iterator(y), false);
+			}
+			_tree->linkNode(x, parent, left);
+			return ft::make_pair(iterator(x), true);
 		}
 
+		template <class... Args>
+		pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+			return emplaceKey(key, std::forward<Args>(args)...);
+		}
+
+		template <class... Args>
+		pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+			return emplaceKey(std::move(key), std::forward<Args>(args)...);
+		}
+
+		template <class M>
+		pair<iterator, bool> insert_or_assign(const Key& key, M&& obj) {
+			pair<iterator, bool> ret = emplaceKey(key, std::forward<M>(obj));
+
+			if (!ret.second)
+				ret.first->second = std::forward<M>(obj);
+			return ret;
+		}
+
+		template <class M>
+		pair<iterator, bool> insert_or_assign(Key&& key, M&& obj) {
+			pair<iterator, bool> ret = emplaceKey(std::move(key), std::forward<M>(obj));
+
+			if (!ret.second)
+				ret.first->second = std::forward<M>(obj);
+			return ret;
+		}
+
+		/* Hangs value next to hint when it belongs there, with at most two
+		** comparisons; the tree is only searched when the hint is wrong. */
 		iterator insert(iterator hint, const value_type& value) {
-			if (hint == end()) {
-				return insertNode(_tree->root, value).first;
+			Node_<value_type, Augment> *pos = hint.base();
+
+			if (pos->isNil()) {
+				if (!empty() && _comp(_tree->getLast()->pair.first, value.first))
+					return attachNode(_tree->getLast(), false, value);
+			} else if (_comp(value.first, pos->pair.first)) {
+				if (pos == _tree->getBegin())
+					return attachNode(pos, true, value);
+				Node_<value_type, Augment> *before = (--hint).base();
+				if (_comp(before->pair.first, value.first))
+					return before->right->isNil() ? attachNode(before, false, value) : attachNode(pos, true, value);
+			} else if (_comp(pos->pair.first, value.first)) {
+				if (pos == _tree->getLast())
+					return attachNode(pos, false, value);
+				Node_<value_type, Augment> *after = (++hint).base();
+				if (_comp(value.first, after->pair.first))
+					return pos->right->isNil() ? attachNode(pos, false, value) : attachNode(after, true, value);
 			} else {
-				if (hint->first > value.first) {
-					iterator prev = hint;
-					--prev;
-					while (prev != end() && prev->first >= value.first) {
-						--hint;
-						--prev;
-					}
-				} else if (hint->first < value.first) {
-					iterator next = hint;
-					++next;
-					while (next != end() && next->first <= value.first) {
-						++hint;
-						++next;
-					}
-				}
+				return pos;
 			}
-			return insertNode(hint.base(), value).first;
+			return insertNode(value).first;
 		}
 
 		template< class InputIt >
 		void insert( InputIt first, InputIt last ) {
-			for (; first != last; first++)
-				insert(ft::make_pair(first->first, first->second));
+			insertRange(first, last);
+		}
+
+		template< class InputIt >
+		void insert( ft::sorted_unique_t, InputIt first, InputIt last ) {
+			if (empty())
+				buildSorted(first, last);
+			else
+				insertRange(first, last);
+		}
+
+		/*
+		** insert() for a large unsorted range, on up to threads threads, 0
+		** meaning one per core. The input is sorted through an array of
+		** indices and the first of each run of equal keys kept, the nodes are
+		** made in one slab run and the tree is laid over them in O(n), its
+		** lower subtrees each on a thread of their own. Keys already here win;
+		** the input is then built apart and merged in.
+		*/
+		template <class RandomIt>
+		void build_parallel( RandomIt first, RandomIt last, unsigned threads = 0 ) {
+			size_type n = last - first, m, blocks;
+
+			if (!empty()) {
+				Map tmp(_comp, _allocator);
+				tmp.build_parallel(first, last, threads);
+				merge(tmp);
+				return;
+			}
+			if (!n) return;
+			ft::Vector<size_type> order(n), kept(n);
+			for (size_type i = 0; i < n; ++i)
+				order[i] = i;
+			ft::parallel_stable_sort(order.data(), order.data() + n, IndexCompare_<RandomIt>(first, &_comp), threads);
+			m = ft::parallel_unique_copy(order.data(), order.data() + n, kept.data(), IndexCompare_<RandomIt>(first, &_comp), threads);
+
+			Node_<value_type, Augment> *run = _pool.allocateRun(m);
+			blocks = ft::parallel_threads(m / ft::parallel_grain, threads);
+			ft::Vector<char> done(blocks, 0);
+			MakeNodes_<RandomIt> make = { *this, first, kept.data(), run, m, blocks, done.data() };
+			try {
+				ft::parallel_for(blocks, blocks, make);
+			} catch (...) {
+				for (size_type b = 0; b < blocks; ++b)
+					for (size_type j = m * b / blocks; done[b] && j < m * (b + 1) / blocks; ++j)
+						_allocator_rebind_node.destroy(run + j);
+				for (size_type j = 0; j < m; ++j)
+					_pool.deallocate(run + j);
+				throw;
+			}
+			_tree->buildSorted(run, m, threads);
+		}
+
+		/* Node handles: extract() unlinks a node without freeing it and
+		** insert() links it back, so moving an entry costs no allocation. An
+		** equivalent key already present leaves the handle in the result. */
+		node_type extract( iterator pos )			{ return node_type(_tree->deleteNode(pos.base()), _pool, _allocator_rebind_node); }
+		node_type extract( const key_type& key )	{ return node_type(_tree->deleteNode(findNode(key)), _pool, _allocator_rebind_node); }
+
+		insert_return_type insert( node_type&& nh ) {
+			insert_return_type ret;
+			Node_<value_type, Augment> *parent, *x;
+			bool left;
+
+			ret.inserted = false;
+			if (nh.empty()) {
+				ret.position = end();
+				return ret;
+			}
+			if ((x = findSlot(nh._node->pair.first, parent, left))) {
+				ret.position = x;
+				ret.node = std::move(nh);
+				return ret;
+			}
+			_pool.give(nh._node, nh._claim);
+			x = nh.release();
+			_tree->linkNode(x, parent, left);
+			ret.position = x;
+			ret.inserted = true;
+			return ret;
 		}
 
 		void erase( iterator pos ) {
 			iterator tmp = pos;
-			_tree->deleteNode(tmp.base());
+			eraseNode(tmp.base());
 		}
 
+		/* Short ranges are unlinked node by node. Longer ones are cut out with
+		** two splits and a join, O(log n) rebalancing plus the release of the
+		** nodes, and a range covering everything is a clear(). */
 		void erase( iterator first, iterator last ) {
-			iterator tmp;
-
-			for (; first != last ;) {
+			iterator tmp = first;
+			DropNode_ drop(*this);
+
+			if (first == begin() && last == end())
+				return clear();
+			for (size_type n = 0; tmp != last; ++tmp, ++n) {
+				if (n == 16)
+					return _tree->eraseRange(first.base(), last.base(), NodeLess_(_comp), drop);
+			}
+			for ( ; first != last ;) {
 				tmp = first++;
-				_tree->deleteNode(tmp.base());
+				eraseNode(tmp.base());
 			}
 		}
 
 		size_type erase( const key_type& key ) {
-			return _tree->deleteNode(find(key).base());
+			return eraseNode(find(key).base());
 		}
 
 		void swap( Map& other ) {
 			std::swap(_tree, other._tree);
+			_pool.swap(other._pool);
 		}
 
 		size_type count( const Key& key ) const {
 			return (find(key) == end()) ? 0 : 1;
 		}
 
-		iterator find( const Key& key ) {
-			Node_<value_type> *current = _tree->root;
+		iterator				find( const Key& key )				{ return findNode(key); }
+		const_iterator			find( const Key& key ) const		{ return findNode(key); }
+		iterator				lower_bound( const Key& key )		{ return lowerNode(key); }
+		const_iterator			lower_bound( const Key& key ) const	{ return lowerNode(key); }
+		iterator				upper_bound( const Key& key )		{ return upperNode(key); }
+		const_iterator			upper_bound( const Key& key ) const	{ return upperNode(key); }
 
-			while (!current->NIL) {
-				if (key == current->pair->first)
-					return (current);
-				else
-					current = _comp(key, current->pair->first) ? current->left : current->right;
-			}
-			return end();
+		pair<iterator,iterator> equal_range( const Key& key ) {
+			return ft::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
 		}
 
-		const_iterator find( const Key& key ) const {
-			Node_<value_type> *current = _tree->root;
+		pair<const_iterator,const_iterator> equal_range( const Key& key ) const {
+			return ft::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+		}
 
-			while (!current->NIL) {
-				if (key == current->pair->first)
-					return (current);
-				else
-					current = _comp(key, current->pair->first) ? current->left : current->right;
-			}
-			return end();
-		}
-
-		iterator lower_bound(const Key& key) {
-			Node_<value_type> *current = _tree->root;
-
-			while (!current->NIL) {
-				if (key == current->pair->first)
-					return iterator(current);
-				else {
-					if (_comp(key, current->pair->first)) {
-						if (!current->left->NIL)
-							current = current->left;
-						else
-							return iterator(current);
-					} else {
-						if (!current->right->NIL)
-							current = current->right;
-						else
-							return ++iterator(current);
-					}
-				}
-			}
-			return end();
-		}
-
-		const_iterator lower_bound( const Key& key ) const {
-			Node_<value_type> *current = _tree->root;
-
-			while (!current->NIL) {
-				if (key == current->pair.first)
-					return const_iterator(current);
-				else {
-					if (_comp(key, current->pair.first)) {
-						if (!current->left->NIL)
-							current = current->left;
-						else
-							return const_iterator(current);
-					} else {
-						if (!current->right->NIL)
-							current = current->right;
-						else
-							return ++const_iterator(current);
-					}
-				}
-			}
-			return end();
+		/* With a transparent Compare the lookups take anything it can compare
+		** against a Key, so probing never builds a temporary key. */
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		find( const K& key )					{ return findNode(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, const_iterator>::type
+		find( const K& key ) const				{ return findNode(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, size_type>::type
+		count( const K& key ) const				{ return findNode(key)->isNil() ? 0 : 1; }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		lower_bound( const K& key )				{ return lowerNode(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, const_iterator>::type
+		lower_bound( const K& key ) const		{ return lowerNode(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, iterator>::type
+		upper_bound( const K& key )				{ return upperNode(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, const_iterator>::type
+		upper_bound( const K& key ) const		{ return upperNode(key); }
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, pair<iterator, iterator> >::type
+		equal_range( const K& key ) {
+			return ft::pair<iterator, iterator>(lowerNode(key), upperNode(key));
 		}
 
-		iterator upper_bound(const Key& key) {
-			iterator tmp = lower_bound(key);
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value, pair<const_iterator, const_iterator> >::type
+		equal_range( const K& key ) const {
+			return ft::pair<const_iterator, const_iterator>(lowerNode(key), upperNode(key));
+		}
+
+		template <class K, class C = Compare>
+		typename ft::enable_if<ft::is_transparent<C>::value && !std::is_convertible<K, iterator>::value, size_type>::type
+		erase( const K& key )					{ return eraseNode(findNode(key)); }
+
+		/* Order statistics, with Augment = ft::OrderStatistics: the element of
+		** rank k, how many keys sort before key, and how many lie in [lo, hi). */
+		iterator				nth( size_type k )			{ return orderTree()->select(k); }
+		const_iterator			nth( size_type k ) const	{ return orderTree()->select(k); }
+		size_type				rank( const Key& key ) const	{ return orderTree()->rank(lowerNode(key)); }
 
-			return (tmp == end()) ? tmp : (_comp(key, tmp->first)) ? tmp : ++tmp;
+		size_type count_range( const Key& lo, const Key& hi ) const {
+			return _comp(lo, hi) ? rank(hi) - rank(lo) : 0;
+		}
+
+		/*
+		** Set algebra on the trees themselves, by red-black split and join: each
+		** takes O(m log(n/m + 1)) for m elements in the other map. merge moves
+		** the nodes of source that are missing here and leaves the conflicting
+		** ones behind, like std::map::merge; set_union copies them instead.
+		** A larger source first trades node sets with this one, so merge splits
+		** along the smaller tree after an O(n + m) pass relinking leaves.
+		** Each node moved is handed over to the pool of the tree it joins.
+		** policy(kept, incoming) settles the mapped value of a key found in
+		** both (ft::KeepExisting, ft::TakeIncoming, or any such callable).
+		** set_intersection and set_difference keep this map's values.
+		*/
+		void merge( Map& source )					{ merge(source, ft::KeepExisting()); }
+		void set_union( const Map& other )			{ set_union(other, ft::KeepExisting()); }
+
+		template <class Policy>
+		void merge( Map& source, Policy policy ) {
+			MoveNodes_<Policy> take(policy, source.size() > size(), _pool, source._pool);
+
+			if (&source == this || source.empty()) return;
+			if (take.swapped) {
+				_tree->exchange(*source._tree);
+				_pool.swap(source._pool);
+			}
+			_tree->unite(source._tree->root, NodeLess_(_comp), take);
+			/* The nodes left over go back to source as they are. */
+			source._tree->reset();
+			source._tree->buildSorted(take.head, take.count);
 		}
 
-		const_iterator upper_bound( const Key& key ) const {
-			const_iterator tmp = lower_bound(key);
+		template <class Policy>
+		void set_union( const Map& other, Policy policy ) {
+			CopyNodes_<Policy> take(*this, policy);
 
-			return (tmp == end()) ? tmp : (_comp(key, tmp->first)) ? tmp : ++tmp;
+			if (&other != this)
+				_tree->unite(static_cast<const Node_<value_type, Augment>*>(other._tree->root), NodeLess_(_comp), take);
 		}
 
-		pair<iterator,iterator> equal_range( const Key& key ) {
-			return ft::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+		void set_intersection( const Map& other ) {
+			DropNode_ drop(*this);
+
+			if (&other != this)
+				_tree->intersect(static_cast<const Node_<value_type, Augment>*>(other._tree->root), NodeLess_(_comp), drop);
 		}
 
-		pair<const_iterator,const_iterator> equal_range( const Key& key ) const {
-			return ft::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+		void set_difference( const Map& other ) {
+			DropNode_ drop(*this);
+
+			if (&other == this)
+				clear();
+			else
+				_tree->subtract(static_cast<const Node_<value_type, Augment>*>(other._tree->root), NodeLess_(_comp), drop);
 		}
 
 		key_compare key_comp() const { return _comp; }
 
-		Map<Key, T, Compare, A>::ValueCompare value_comp() const { return ValueCompare(key_comp()); }
+		Map<Key, T, Compare, A, Augment>::ValueCompare value_comp() const { return ValueCompare(key_comp()); }
 
 		friend bool operator== (const Map &lhs, const Map &rhs) { return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin()); }
 		friend bool operator!= (const Map &lhs, const Map &rhs) { return !(lhs == rhs); }
@@ -274,62 +561,335 @@ namespace ft {
 		friend bool operator<= (const Map &lhs, const Map &rhs) { return !(rhs < lhs); }
 
 	private:
-		void fillTree(Node_<value_type> *t) {
-			if (!t->left->NIL)
-				fillTree(t->left);
-			if (!t->NIL) insert(*t->pair);
-			if (!t->right->NIL)
-				fillTree(t->right);
-		}
-
-		void clearTree(Node_<value_type> *tmp) {
-			if (tmp->NIL) return;
-			if (!tmp->left->NIL) clearTree(tmp->left);
-			if (!tmp->right->NIL) clearTree(tmp->right);
+		struct NodeLess_ {
+			const Compare &comp;
+			NodeLess_(const Compare& c) : comp(c) {}
+			bool operator()(const Node_<value_type, Augment> *a, const Node_<value_type, Augment> *b) const {
+				return comp(a->pair.first, b->pair.first);
+			}
+		};
+
+		template <class RandomIt>
+		struct IndexCompare_ {
+			RandomIt		first;
+			const Compare	*comp;
+			IndexCompare_(RandomIt f, const Compare *c): first(f), comp(c) {}
+			bool operator()(size_type a, size_type b) const { return (*comp)(first[a].first, first[b].first); }
+		};
+
+		/* Makes the nodes of block b of run, or none of them. */
+		template <class RandomIt>
+		struct MakeNodes_ {
+			Map							&map;
+			RandomIt					first;
+			const size_type				*kept;
+			Node_<value_type, Augment>	*run;
+			size_type					count;
+			size_type					blocks;
+			char						*done;
+
+			void operator()(size_type b) const {
+				size_type begin = count * b / blocks, j = begin;
+
+				try {
+					for ( ; j < count * (b + 1) / blocks; ++j)
+						map._allocator_rebind_node.construct(run + j, value_type(first[kept[j]].first, first[kept[j]].second));
+				} catch (...) {
+					while (j-- > begin)
+						map._allocator_rebind_node.destroy(run + j);
+					throw;
+				}
+				done[b] = 1;
+			}
+		};
+
+		/* Nodes of source are moved as they are. When the maps were swapped
+		** for speed the kept node of a conflict is the one from other; either
+		** way the loser is chained in order, through right, for source. */
+		template <class Policy>
+		struct MoveNodes_ {
+			Policy						policy;
+			bool						swapped;
+			pool_type					*to, *from;
+			Node_<value_type, Augment>	*head, *tail;
+			size_type					count;
+
+			MoveNodes_(Policy p, bool s, pool_type& into, pool_type& source) : policy(p), swapped(s), to(&into), from(&source), head(0), tail(0), count(0) {}
+			Node_<value_type, Augment>* operator()(Node_<value_type, Augment> *t) {
+				to->transfer(t, *from);
+				return t;
+			}
+			Node_<value_type, Augment>* duplicate(Node_<value_type, Augment> *found, Node_<value_type, Augment> *t) {
+				Node_<value_type, Augment> *kept = swapped ? t : found, *other = swapped ? found : t;
+
+				policy(kept->pair.second, other->pair.second);
+				if (swapped) {
+					to->transfer(t, *from);
+					from->transfer(found, *to);
+				}
+				other->right = 0;
+				(tail ? tail->right : head) = other;
+				tail = other;
+				++count;
+				return kept;
+			}
+		};
+
+		template <class Policy>
+		struct CopyNodes_ {
+			Map		&map;
+			Policy	policy;
+
+			CopyNodes_(Map& m, Policy p) : map(m), policy(p) {}
+			Node_<value_type, Augment>* operator()(const Node_<value_type, Augment> *t) { return map.createNode(t->pair); }
+			Node_<value_type, Augment>* duplicate(Node_<value_type, Augment> *found, const Node_<value_type, Augment> *t) {
+				policy(found->pair.second, t->pair.second);
+				return found;
+			}
+		};
+
+		struct DropNode_ {
+			Map	&map;
+			DropNode_(Map& m) : map(m) {}
+			void operator()(Node_<value_type, Augment> *x) { map.destroyNode(x); }
+		};
+
+		Tree<value_type, Augment>* orderTree() const {
+			static_assert(std::is_same<Augment, ft::OrderStatistics>::value, "order statistics need Augment = ft::OrderStatistics");
+			return _tree;
+		}
+
+		Node_<value_type, Augment>* cloneNode(const Node_<value_type, Augment> *src, Node_<value_type, Augment> *parent) {
+			Node_<value_type, Augment> *x = _pool.allocate();
+
+			_allocator_rebind_node.construct(x, src->pair);
+			x->parent = parent;
+			x->left = &_tree->sentinel;
+			x->right = &_tree->sentinel;
+			x->setColor(src->color());
+			Tree<value_type, Augment>::copyAugment(x, src);
+			return x;
+		}
+
+		/* Copies other node by node, keeping its shape and colours: O(n), no
+		** comparisons and no recursion. The tree has to be empty. */
+		void copyTree(const Tree<value_type, Augment>& other) {
+			const Node_<value_type, Augment> *src = other.root;
+
+			if (src->isNil()) return;
+			_pool.reserve(other.m_size);
+			_tree->root = cloneNode(src, 0);
+			for (Node_<value_type, Augment> *dst = _tree->root; dst; ) {
+				if (!src->left->isNil() && dst->left->isNil()) {
+					dst->left = cloneNode(src->left, dst);
+					src = src->left;
+					dst = dst->left;
+				} else if (!src->right->isNil() && dst->right->isNil()) {
+					dst->right = cloneNode(src->right, dst);
+					src = src->right;
+					dst = dst->right;
+				} else {
+					if (src == other.m_begin) _tree->m_begin = dst;
+					if (src == other.sentinel.parent) _tree->sentinel.parent = dst;
+					src = src->parent;
+					dst = dst->parent;
+				}
+			}
+			_tree->m_size = other.m_size;
+			_tree->rethread();
+		}
+
+		void clearTree(Node_<value_type, Augment> *tmp) {
+			if (tmp->isNil()) return;
+			if (!tmp->left->isNil()) clearTree(tmp->left);
+			if (!tmp->right->isNil()) clearTree(tmp->right);
 			_allocator_rebind_node.destroy(tmp);
-			_allocator_rebind_node.deallocate(tmp, sizeof(Node_<value_type>));
+		}
+
+		/* Slabs go back in one sweep; only non-trivial payloads need the walk. */
+		void destroyNodes() {
+			if (!std::is_trivially_destructible<Node_<value_type, Augment> >::value)
+				clearTree(_tree->root);
+			_pool.release();
 		}
 
 		void clearMap() {
-			clearTree(_tree->root);
+			destroyNodes();
 			_allocator_rebind_tree.destroy(_tree);
-			_allocator_rebind_tree.deallocate(_tree, sizeof(Tree<value_type>));
+			_allocator_rebind_tree.deallocate(_tree, 1);
+		}
+
+		/* Lookups only use _comp, one comparison per level; find() adds a
+		** single equivalence check on the candidate it lands on. */
+		template <class K>
+		Node_<value_type, Augment>* lowerNode(const K& key) const {
+			Node_<value_type, Augment> *current = _tree->root, *result = _tree->getEnd();
+
+			while (!current->isNil()) {
+				if (_comp(current->pair.first, key)) {
+					current = current->right;
+				} else {
+					result = current;
+					current = current->left;
+				}
+			}
+			return result;
 		}
 
-		pair<iterator, bool> insertNode(Node_<value_type> *hint, const value_type& value) {
-			Node_<value_type> *current, *parent, *x;
+		template <class K>
+		Node_<value_type, Augment>* upperNode(const K& key) const {
+			Node_<value_type, Augment> *current = _tree->root, *result = _tree->getEnd();
 
-			current = hint;
-			parent = 0;
-			while (!current->NIL) {
-				if (value.first == current->pair->first) return ft::make_pair(current, false);
-				parent = current;
-				current = _comp(value.first, current->pair->first) ? current->left : current->right;
+			while (!current->isNil()) {
+				if (_comp(key, current->pair.first)) {
+					result = current;
+					current = current->left;
+				} else {
+					current = current->right;
+				}
 			}
+			return result;
+		}
+
+		template <class K>
+		Node_<value_type, Augment>* findNode(const K& key) const {
+			Node_<value_type, Augment> *x = lowerNode(key);
+
+			return (x->isNil() || _comp(key, x->pair.first)) ? _tree->getEnd() : x;
+		}
+
+		Node_<value_type, Augment>* createNode(const value_type& value) {
+			Node_<value_type, Augment> *x = _pool.allocate();
 
-			x = _allocator_rebind_node.allocate(sizeof(Node_<value_type>));
 			_allocator_rebind_node.construct(x, value);
-			x->parent = parent;
-			x->left = &_tree->sentinel;
-			x->right = &_tree->sentinel;
-			x->color = 1;
+			return x;
+		}
 
-			if (parent) {
-				if (_comp(value.first, parent->pair->first))
-					parent->left = x;
-				else
-					parent->right = x;
-			} else {
-				_tree->root = x;
+		Node_<value_type, Augment>* createNode(value_type&& value) {
+			Node_<value_type, Augment> *x = _pool.allocate();
+
+			_allocator_rebind_node.construct(x, std::move(value));
+			return x;
+		}
+
+		void destroyNode(Node_<value_type, Augment> *x) {
+			_allocator_rebind_node.destroy(x);
+			_pool.deallocate(x);
+		}
+
+		size_type eraseNode(Node_<value_type, Augment> *z) {
+			Node_<value_type, Augment> *y = _tree->deleteNode(z);
+
+			if (!y) return 0;
+			destroyNode(y);
+			return 1;
+		}
+
+		/* Descends to the slot key belongs in. Returns the node holding an
+		** equivalent key, or NULL with parent and side set for linkNode. */
+		Node_<value_type, Augment>* findSlot(const Key& key, Node_<value_type, Augment> *&parent, bool &left) {
+			Node_<value_type, Augment> *current = _tree->root, *candidate = NULL;
+
+			parent = NULL;
+			left = true;
+			while (!current->isNil()) {
+				parent = current;
+				if ((left = _comp(key, current->pair.first))) {
+					current = current->left;
+				} else {
+					candidate = current;
+					current = current->right;
+				}
 			}
+			return (candidate && !_comp(candidate->pair.first, key)) ? candidate : NULL;
+		}
 
-			_tree->insertFixup(x);
+		template <class V>
+		pair<iterator, bool> insertNode(V&& value) {
+			Node_<value_type, Augment> *parent, *x;
+			bool left;
 
-			if (x == _tree->getLast()) { _tree->sentinel.parent = x; }
-			if (x == _tree->getBegin()) { _tree->sentinel.begin = x; }
-			_tree->m_size++;
+			if ((x = findSlot(value.first, parent, left)))
+				return ft::make_pair(x, false);
+			x = createNode(std::forward<V>(value));
+			_tree->linkNode(x, parent, left);
 			return ft::make_pair(x, true);
 		}
+
+		template <class K, class... Args>
+		pair<iterator, bool> emplaceKey(K&& key, Args&&... args) {
+			Node_<value_type, Augment> *parent, *x;
+			bool left;
+
+			if ((x = findSlot(key, parent, left)))
+				return ft::make_pair(iterator(x), false);
+			x = createNode(value_type(std::forward<K>(key), T(std::forward<Args>(args)...)));
+			_tree->linkNode(x, parent, left);
+			return ft::make_pair(iterator(x), true);
+		}
+
+		iterator attachNode(Node_<value_type, Augment> *parent, bool left, const value_type& value) {
+			Node_<value_type, Augment> *x = createNode(value);
+
+			_tree->linkNode(x, parent, left);
+			return x;
+		}
+
+		/* Builds an empty tree from input trusted to be sorted and unique. */
+		template <class InputIt>
+		void buildSorted(InputIt first, InputIt last) {
+			Node_<value_type, Augment> *head = 0, *tail = 0;
+			size_type n = 0;
+
+			for ( ; first != last; ++first, ++n) {
+				Node_<value_type, Augment> *x = createNode(value_type(first->first, first->second));
+				x->right = 0;
+				(tail ? tail->right : head) = x;
+				tail = x;
+			}
+			_tree->buildSorted(head, n);
+		}
+
+		/* The input is turned into a chain of nodes first. When the tree is empty
+		** and the chain came out sorted it is built in O(n); otherwise every node
+		** is linked in on its own, as plain insert() would. */
+		template <class InputIt>
+		void insertRange(InputIt first, InputIt last) {
+			Node_<value_type, Augment> *head = 0, *tail = 0, *parent, *x;
+			size_type n = 0;
+			bool sorted = true, left;
+
+			if (!empty()) {
+				for ( ; first != last; ++first)
+					insert(end(), value_type(first->first, first->second));
+				return;
+			}
+			for ( ; first != last; ++first) {
+				x = createNode(value_type(first->first, first->second));
+				x->right = 0;
+				if (tail && !_comp(tail->pair.first, x->pair.first)) {
+					if (!_comp(x->pair.first, tail->pair.first)) {
+						destroyNode(x);
+						continue;
+					}
+					sorted = false;
+				}
+				(tail ? tail->right : head) = x;
+				tail = x;
+				++n;
+			}
+			if (sorted) {
+				_tree->buildSorted(head, n);
+				return;
+			}
+			for ( ; head; head = x) {
+				x = head->right;
+				if (findSlot(head->pair.first, parent, left))
+					destroyNode(head);
+				else
+					_tree->linkNode(head, parent, left);
+			}
+		}
 	};
 }
 
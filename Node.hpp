@@ -2,62 +2,247 @@
 #ifndef NODE_HPP
 #define NODE_HPP
 
-template <class Type>
-struct Node_ {
+# include <cstddef>
+# include <cstdint>
+# include <utility>
+# include "Parallel.hpp"
+# include "Vector.hpp"
+
+namespace ft {
+	/* Node augmentation policies for Map and Set. */
+	struct PlainTree {};
+	struct OrderStatistics {};
+	struct Threaded {};
+}
+
+/* Ring hooks for policies that do not thread their nodes: all empty. */
+struct NodeUnthreaded_ {
+	template <class Node> static void linkAfter(Node *, Node *) {}
+	template <class Node> static void linkBefore(Node *, Node *) {}
+	template <class Node> static void unlink(Node *) {}
+	template <class Node> static void unlinkRange(Node *, Node *) {}
+	template <class Node> static void rethread(Node *, Node *) {}
+};
+
+/* The default policy adds nothing: its hooks are empty and the base is empty. */
+template <class Augment>
+struct NodeAugment_ : public NodeUnthreaded_ {
+	template <class Node> static void pull(Node *) {}
+	template <class Node> static void adjust(Node *, ptrdiff_t) {}
+	template <class Node> static size_t size(Node *) { return 0; }
+};
+
+/* Keeps the size of each node's subtree, so rank and select take O(log n).
+** The sentinel holds 0 and stands in for every empty subtree. */
+template <>
+struct NodeAugment_<ft::OrderStatistics> : public NodeUnthreaded_ {
+	size_t count;
+	NodeAugment_() : count(0) {}
+
+	template <class Node>
+	static void pull(Node *x) { x->count = x->left->count + x->right->count + 1; }
+
+	/* Adds delta to every subtree on the path from x up to the root. */
+	template <class Node>
+	static void adjust(Node *x, ptrdiff_t delta) {
+		for ( ; x; x = x->parent)
+			x->count += delta;
+	}
+
+	template <class Node>
+	static size_t size(Node *x) { return x->count; }
+
+	/* Number of nodes before x; the sentinel ranks after the last node. */
+	template <class Node>
+	static size_t rank(Node *x) {
+		size_t r;
+
+		if (x->isNil()) {
+			for (x = x->parent; !x->isNil() && x->parent; x = x->parent) ;
+			return x->count;
+		}
+		r = x->left->count;
+		for ( ; x->parent; x = x->parent)
+			if (x == x->parent->right)
+				r += x->parent->left->count + 1;
+		return r;
+	}
+
+	/* The node of rank k in the tree holding x, or the sentinel when k is
+	** out of range. */
+	template <class Node>
+	static Node* select(Node *x, ptrdiff_t k) {
+		if (x->isNil())
+			x = x->parent;
+		if (x->isNil())
+			return x;
+		while (x->parent)
+			x = x->parent;
+		if (k < 0 || (size_t)k >= x->count) {
+			while (!x->isNil())
+				x = x->right;
+			return x;
+		}
+		for (size_t i = k; i != x->left->count; ) {
+			if (i < x->left->count) {
+				x = x->left;
+			} else {
+				i -= x->left->count + 1;
+				x = x->right;
+			}
+		}
+		return x;
+	}
+};
+
+/*
+** Threads the nodes into a ring in key order, closed through the sentinel,
+** so that iterators step with a single load instead of climbing parent
+** links: O(1) in the worst case, which pays off for cursors that advance
+** a step at a time between other work. One tight scan of the whole tree
+** gains nothing, as the plain walk mostly climbs to ancestors still in
+** cache and the nodes here are two pointers larger. Inserts and erases
+** patch the ring in O(1); the bulk set algebra rebuilds the tree wholesale
+** and relinks it in one O(n) walk.
+*/
+template <>
+struct NodeAugment_<ft::Threaded> : public NodeAugment_<ft::PlainTree> {
+	NodeAugment_ *pred;
+	NodeAugment_ *succ;
+	NodeAugment_() : pred(this), succ(this) {}
+
+	template <class Node>
+	static void linkAfter(Node *x, Node *prev) {
+		x->pred = prev;
+		x->succ = prev->succ;
+		prev->succ->pred = x;
+		prev->succ = x;
+	}
+
+	template <class Node>
+	static void linkBefore(Node *x, Node *next) { linkAfter(x, static_cast<Node*>(next->pred)); }
+
+	template <class Node>
+	static void unlink(Node *x) {
+		x->pred->succ = x->succ;
+		x->succ->pred = x->pred;
+	}
+
+	/* Cuts [first, last) out of the ring; last may be the sentinel. */
+	template <class Node>
+	static void unlinkRange(Node *first, Node *last) {
+		first->pred->succ = last;
+		last->pred = first->pred;
+	}
+
+	/* Relinks the ring in key order by walking the tree through its
+	** parent links. */
+	template <class Node>
+	static void rethread(Node *sentinel, Node *root) {
+		NodeAugment_ *prev = sentinel;
+		Node *x = root, *child;
+
+		if (!x->isNil())
+			while (!x->left->isNil()) x = x->left;
+		while (x && !x->isNil()) {
+			prev->succ = x;
+			x->pred = prev;
+			prev = x;
+			if (!x->right->isNil()) {
+				for (x = x->right; !x->left->isNil(); )
+					x = x->left;
+			} else {
+				do {
+					child = x;
+					x = x->parent;
+				} while (x && child == x->right);
+			}
+		}
+		prev->succ = sentinel;
+		sentinel->pred = prev;
+	}
+};
+
+/* A parent link carrying its node's colour in the low bit, which node
+** alignment leaves clear. It reads as a plain pointer, and assigning a link
+** keeps the colour of the node it belongs to. */
+template <class Node>
+class ParentLink_ {
+	std::uintptr_t	_bits;
+
 public:
-	Node_() : color(0), begin(NULL), left(this), right(this), parent(0), NIL(1), pair(new Type()) {}
-	Node_(const Type& p) : color(0), begin(NULL), left(this), right(this), parent(0), NIL(0), pair(new Type(p)) {}
-	~Node_() { delete pair; }
-	bool color;
-	struct Node_ *begin;
+	explicit ParentLink_(Node *p = NULL) : _bits(reinterpret_cast<std::uintptr_t>(p)) {}
+	ParentLink_& operator=(Node *p) {
+		_bits = reinterpret_cast<std::uintptr_t>(p) | (_bits & 1);
+		return *this;
+	}
+	ParentLink_& operator=(const ParentLink_& other)	{ return *this = static_cast<Node*>(other); }
+	operator Node*() const								{ return reinterpret_cast<Node*>(_bits & ~static_cast<std::uintptr_t>(1)); }
+	Node* operator->() const							{ return *this; }
+	bool color() const									{ return _bits & 1; }
+	void setColor(bool red)								{ _bits = (_bits & ~static_cast<std::uintptr_t>(1)) | red; }
+};
+
+/* Three words ahead of the payload: the colour rides in parent, and the only
+** node whose left link points to itself is the sentinel. */
+template <class Type, class Augment = ft::PlainTree>
+struct Node_ : public NodeAugment_<Augment> {
+public:
+	Node_() : left(this), right(this), parent(), pair() {}
+	Node_(const Type& p) : left(NULL), right(NULL), parent(), pair(p) {}
+	Node_(Type&& p) : left(NULL), right(NULL), parent(), pair(std::move(p)) {}
 	struct Node_ *left;
 	struct Node_ *right;
-	struct Node_ *parent;
-	bool NIL;
-	Type *pair;
+	ParentLink_<Node_> parent;
+	Type pair;
+
+	bool isNil() const				{ return left == this; }
+	bool color() const				{ return parent.color(); }
+	void setColor(bool red)			{ parent.setColor(red); }
 };
 
-template <class Type>
+template <class Type, class Augment = ft::PlainTree>
 class Tree {
 public:
-	Node_<Type> sentinel;
-	Node_<Type> *root;
+	Node_<Type, Augment> sentinel;
+	Node_<Type, Augment> *root;
+	Node_<Type, Augment> *m_begin;
 	size_t m_size;
 	Tree() : m_size(0) {
-		sentinel.left = &sentinel;
-		sentinel.right = &sentinel;
-		sentinel.begin = &sentinel;
-		sentinel.parent = 0;
-		sentinel.color = 0;
-		sentinel.NIL = true;
-		root = &sentinel;
+		reset();
 	}
 
-	Tree(Tree<Type> &other) : m_size(0) {
-		sentinel.left = &sentinel;
-		sentinel.right = &sentinel;
-		sentinel.begin = &sentinel;
-		sentinel.parent = 0;
-		sentinel.color = 0;
-		sentinel.NIL = (&other == &other);
-		root = &sentinel;
+	Tree(Tree<Type, Augment> &) : m_size(0) {
+		reset();
 	}
 
-	Tree& operator=(const Tree<Type>& other) {
+	Tree& operator=(const Tree<Type, Augment>& other) {
 		if (this == &other)
 			return *this;
 		root = other.root;
 		sentinel = other.sentinel;
+		m_begin = other.m_begin;
 		m_size = other.m_size;
 		return *this;
 	};
 
-	void rotateLeft(Node_<Type> *x) {
-		Node_<Type> *y = x->right;
+	void reset() {
+		sentinel.left = &sentinel;
+		sentinel.right = &sentinel;
+		m_begin = &sentinel;
+		sentinel.parent = &sentinel;
+		sentinel.setColor(0);
+		root = &sentinel;
+		m_size = 0;
+		rethread();
+	}
+
+	void rotateLeft(Node_<Type, Augment> *x) {
+		Node_<Type, Augment> *y = x->right;
 
 		x->right = y->left;
-		if (!y->left->NIL) y->left->parent = x;
-		if (!y->NIL) y->parent = x->parent;
+		if (!y->left->isNil()) y->left->parent = x;
+		if (!y->isNil()) y->parent = x->parent;
 		if (x->parent) {
 			if (x == x->parent->left)
 				x->parent->left = y;
@@ -67,15 +252,17 @@ public:
 			root = y;
 		}
 		y->left = x;
-		if (!x->NIL) x->parent = y;
+		if (!x->isNil()) x->parent = y;
+		Node_<Type, Augment>::pull(x);
+		Node_<Type, Augment>::pull(y);
 	}
 
-	void rotateRight(Node_<Type> *x) {
-		Node_<Type> *y = x->left;
+	void rotateRight(Node_<Type, Augment> *x) {
+		Node_<Type, Augment> *y = x->left;
 
 		x->left = y->right;
-		if (!y->right->NIL) y->right->parent = x;
-		if (!y->NIL) y->parent = x->parent;
+		if (!y->right->isNil()) y->right->parent = x;
+		if (!y->isNil()) y->parent = x->parent;
 		if (x->parent) {
 			if (x == x->parent->right)
 				x->parent->right = y;
@@ -85,166 +272,670 @@ public:
 			root = y;
 		}
 		y->right = x;
-		if (!x->NIL) x->parent = y;
+		if (!x->isNil()) x->parent = y;
+		Node_<Type, Augment>::pull(x);
+		Node_<Type, Augment>::pull(y);
 	}
 
-	void insertFixup(Node_<Type> *x) {
-		while (x != root && x->parent->color == 1) {
+	/* Returns whether the root had to be blackened, which is when the black
+	** height of the tree grew by one. */
+	bool insertFixup(Node_<Type, Augment> *x) {
+		while (x != root && x->parent->color() == 1) {
 			if (x->parent == x->parent->parent->left) {
-				Node_<Type> *y = x->parent->parent->right;
-				if (y->color == 1) {
-					x->parent->color = 0;
-					y->color = 0;
-					x->parent->parent->color = 1;
+				Node_<Type, Augment> *y = x->parent->parent->right;
+				if (y->color() == 1) {
+					x->parent->setColor(0);
+					y->setColor(0);
+					x->parent->parent->setColor(1);
 					x = x->parent->parent;
 				} else {
 					if (x == x->parent->right) {
 						x = x->parent;
 						rotateLeft(x);
 					}
-					x->parent->color = 0;
-					x->parent->parent->color = 1;
+					x->parent->setColor(0);
+					x->parent->parent->setColor(1);
 					rotateRight(x->parent->parent);
 				}
 			} else {
-				Node_<Type> *y = x->parent->parent->left;
-				if (y->color == 1) {
-					x->parent->color = 0;
-					y->color = 0;
-					x->parent->parent->color = 1;
+				Node_<Type, Augment> *y = x->parent->parent->left;
+				if (y->color() == 1) {
+					x->parent->setColor(0);
+					y->setColor(0);
+					x->parent->parent->setColor(1);
 					x = x->parent->parent;
 				} else {
 					if (x == x->parent->left) {
 						x = x->parent;
 						rotateRight(x);
 					}
-					x->parent->color = 0;
-					x->parent->parent->color = 1;
+					x->parent->setColor(0);
+					x->parent->parent->setColor(1);
 					rotateLeft(x->parent->parent);
 				}
 			}
 		}
-		root->color = 0;
+		bool grew = root->color() == 1;
+		root->setColor(0);
+		return grew;
+	}
+
+	/* Hangs a fresh node under parent (or makes it the root) and rebalances. */
+	void linkNode(Node_<Type, Augment> *x, Node_<Type, Augment> *parent, bool left) {
+		x->parent = parent;
+		x->left = &sentinel;
+		x->right = &sentinel;
+		x->setColor(1);
+		Node_<Type, Augment>::pull(x);
+		Node_<Type, Augment>::adjust(parent, 1);
+		if (!parent) {
+			root = x;
+			m_begin = x;
+			sentinel.parent = x;
+			Node_<Type, Augment>::linkAfter(x, &sentinel);
+		} else if (left) {
+			parent->left = x;
+			if (parent == m_begin) m_begin = x;
+			Node_<Type, Augment>::linkBefore(x, parent);
+		} else {
+			parent->right = x;
+			if (parent == sentinel.parent) sentinel.parent = x;
+			Node_<Type, Augment>::linkAfter(x, parent);
+		}
+		insertFixup(x);
+		m_size++;
 	}
 
-	void deleteFixup(Node_<Type> *x) {
-		while (x != root && x->color == 0) {
+	void deleteFixup(Node_<Type, Augment> *x) {
+		while (x != root && x->color() == 0) {
 			if (x == x->parent->left) {
-				Node_<Type> *w = x->parent->right;
-				if (w->color == 1) {
-					w->color = 0;
-					x->parent->color = 1;
+				Node_<Type, Augment> *w = x->parent->right;
+				if (w->color() == 1) {
+					w->setColor(0);
+					x->parent->setColor(1);
 					rotateLeft(x->parent);
 					w = x->parent->right;
 				}
-				if (w->left->color == 0 && w->right->color == 0) {
-					w->color = 1;
+				if (w->left->color() == 0 && w->right->color() == 0) {
+					w->setColor(1);
 					x = x->parent;
 				} else {
-					if (w->right->color == 0) {
-						w->left->color = 0;
-						w->color = 1;
+					if (w->right->color() == 0) {
+						w->left->setColor(0);
+						w->setColor(1);
 						rotateRight (w);
 						w = x->parent->right;
 					}
-					w->color = x->parent->color;
-					x->parent->color = 0;
-					w->right->color = 0;
+					w->setColor(x->parent->color());
+					x->parent->setColor(0);
+					w->right->setColor(0);
 					rotateLeft(x->parent);
 					x = root;
 				}
 			} else {
-				Node_<Type> *w = x->parent->left;
-				if (w->color == 1) {
-					w->color = 0;
-					x->parent->color = 1;
+				Node_<Type, Augment> *w = x->parent->left;
+				if (w->color() == 1) {
+					w->setColor(0);
+					x->parent->setColor(1);
 					rotateRight (x->parent);
 					w = x->parent->left;
 				}
-				if (w->right->color == 0 && w->left->color == 0) {
-					w->color = 1;
+				if (w->right->color() == 0 && w->left->color() == 0) {
+					w->setColor(1);
 					x = x->parent;
 				} else {
-					if (w->left->color == 0) {
-						w->right->color = 0;
-						w->color = 1;
+					if (w->left->color() == 0) {
+						w->right->setColor(0);
+						w->setColor(1);
 						rotateLeft(w);
 						w = x->parent->left;
 					}
-					w->color = x->parent->color;
-					x->parent->color = 0;
-					w->left->color = 0;
+					w->setColor(x->parent->color());
+					x->parent->setColor(0);
+					w->left->setColor(0);
 					rotateRight(x->parent);
 					x = root;
 				}
 			}
 		}
-		x->color = 0;
+		x->setColor(0);
 	}
 
-	int deleteNode(Node_<Type> *z) {
-		Node_<Type> *x, *y;
+	/* Unlinks z and hands it back for the caller to release. */
+	Node_<Type, Augment>* deleteNode(Node_<Type, Augment> *z) {
+		Node_<Type, Augment> *x, *y;
 
-		if (!z || z->NIL) return 0;
+		if (!z || z->isNil()) return NULL;
 
-		if (z->left->NIL || z->right->NIL) {
-			y = z;
+		/* m_begin and sentinel.parent cache the extremes; x may be the sentinel and
+		** have its parent overwritten below, so the new values are restored last. */
+		Node_<Type, Augment> *first = m_begin, *last = sentinel.parent;
+		if (z == first) {
+			first = z->right;
+			if (first->isNil())
+				first = z->parent ? z->parent : &sentinel;
+			else
+				while (!first->left->isNil()) first = first->left;
+		}
+		if (z == last) {
+			last = z->left;
+			if (last->isNil())
+				last = z->parent ? z->parent : &sentinel;
+			else
+				while (!last->right->isNil()) last = last->right;
+		}
+
+		/* z is taken out by relinking: with two children its successor y is
+		** spliced into z's place, so no value is copied or moved. */
+		bool color = z->color();
+		if (z->left->isNil()) {
+			x = z->right;
+			Node_<Type, Augment>::adjust(static_cast<Node_<Type, Augment>*>(z->parent), -1);
+			transplant(z, x);
+		} else if (z->right->isNil()) {
+			x = z->left;
+			Node_<Type, Augment>::adjust(static_cast<Node_<Type, Augment>*>(z->parent), -1);
+			transplant(z, x);
 		} else {
 			y = z->right;
-			while (!y->left->NIL)
+			while (!y->left->isNil())
 				y = y->left;
+			Node_<Type, Augment>::adjust(static_cast<Node_<Type, Augment>*>(y->parent), -1);
+			color = y->color();
+			x = y->right;
+			if (y->parent == z) {
+				x->parent = y;
+			} else {
+				transplant(y, x);
+				y->right = z->right;
+				y->right->parent = y;
+			}
+			transplant(z, y);
+			y->left = z->left;
+			y->left->parent = y;
+			y->setColor(z->color());
+			Node_<Type, Augment>::pull(y);
+		}
+
+		if (color == 0)
+			deleteFixup(x);
+		m_begin = first;
+		sentinel.parent = last;
+		Node_<Type, Augment>::unlink(z);
+		m_size--;
+		return z;
+	}
+
+	/* Turns n nodes chained through right in ascending order into a balanced
+	** tree in O(n). Every level above the deepest one is complete, so only the
+	** deepest level is coloured red. The tree has to be empty. */
+	void buildSorted(Node_<Type, Augment> *head, size_t n) {
+		size_t red = 0;
+
+		if (!n) return;
+		while ((((size_t)2 << red) - 1) <= n)
+			++red;
+		m_begin = head;
+		root = buildRange(head, n, 0, red);
+		root->parent = 0;
+		for (sentinel.parent = root; !sentinel.parent->right->isNil(); )
+			sentinel.parent = sentinel.parent->right;
+		m_size = n;
+	}
+
+	/* Builds an empty tree out of n nodes lying in key order in one array,
+	** in the shape buildSorted gives a chain. Under the top few levels the
+	** subtrees share nothing, so they are built on up to threads threads
+	** first and the top is laid over them afterwards. */
+	void buildSorted(Node_<Type, Augment> *run, size_t n, unsigned threads) {
+		ft::Vector<Node_<Type, Augment>*> roots;
+		ft::Vector<Node_<Type, Augment>*> pieces;
+		ft::Vector<size_t> sizes;
+		size_t red = 0, cut = 0, next = 0;
+
+		if (!n) return;
+		while ((((size_t)2 << red) - 1) <= n)
+			++red;
+		for (threads = ft::parallel_threads(n / ft::parallel_grain, threads); threads > 1 && ((size_t)1 << cut) < 4 * (size_t)threads; )
+			++cut;
+		cutRun(run, n, 0, cut, pieces, sizes);
+		roots.resize(pieces.size());
+		BuildPiece_ build = { this, pieces.data(), sizes.data(), roots.data(), cut, red };
+		ft::parallel_for(pieces.size(), threads, build);
+		root = buildRun(run, n, 0, red, cut, roots.data(), next);
+		root->parent = 0;
+		m_begin = run;
+		sentinel.parent = run + n - 1;
+		m_size = n;
+		rethread();
+	}
+
+	/*
+	** Join-based set algebra, after Blelloch, Ferizovic and Sun: this tree is
+	** split around each element of other and the pieces are joined back, in
+	** O(m log(n/m + 1)) for m elements in other. other is only read, so it
+	** may be const. less orders two nodes; take(t) hands back the node that
+	** stands for t in this tree (t itself when it is moved, or a copy) and
+	** take.duplicate(x, t) picks between x and an equivalent t. drop(x)
+	** releases a node of this tree that left it.
+	*/
+	template <class S, class Less, class Take>
+	void unite(S other, const Less& less, Take& take) {
+		size_t n = m_size, h;
+		Node_<Type, Augment> *t;
+
+		t = uniteTrees(root, blackHeight(root), other, blackHeight(other), less, take, n, h);
+		settle(t, n);
+		rethread();
+	}
+
+	template <class S, class Less, class Drop>
+	void intersect(S other, const Less& less, Drop& drop) {
+		size_t n = 0, h;
+		Node_<Type, Augment> *t;
+
+		t = intersectTrees(root, blackHeight(root), other, blackHeight(other), less, drop, n, h);
+		settle(t, n);
+		rethread();
+	}
+
+	template <class S, class Less, class Drop>
+	void subtract(S other, const Less& less, Drop& drop) {
+		size_t n = m_size, h;
+		Node_<Type, Augment> *t;
+
+		t = subtractTrees(root, blackHeight(root), other, blackHeight(other), less, drop, n, h);
+		settle(t, n);
+		rethread();
+	}
+
+	/* Unlinks [first, last) by splitting the tree at both ends and joining
+	** what lies outside: O(log n) rebalancing whatever the length of the
+	** range, then one pass handing the nodes to drop. */
+	template <class Less, class Drop>
+	void eraseRange(Node_<Type, Augment> *first, Node_<Type, Augment> *last, const Less& less, Drop& drop) {
+		Node_<Type, Augment> *l, *m, *r, *bound;
+		size_t hl, hm, hr, h, n = m_size;
+
+		if (first == last) return;
+		Node_<Type, Augment>::unlinkRange(first, last);
+		split(root, blackHeight(root), first, less, l, hl, m, hm);
+		if (last->isNil()) {
+			r = &sentinel;
+			hr = 0;
+			bound = NULL;
+		} else {
+			bound = split(m, hm, last, less, m, hm, r, hr);
 		}
+		n -= dropTree(m, drop) + 1;
+		drop(first);
+		settle(bound ? join(l, hl, bound, r, hr, h) : l, n);
+	}
+
+	/* Order statistics; only available with ft::OrderStatistics. */
+	Node_<Type, Augment>* select(size_t k)				{ return root->isNil() ? &sentinel : Node_<Type, Augment>::select(root, k); }
+	size_t rank(const Node_<Type, Augment> *x) const	{ return Node_<Type, Augment>::rank(x); }
 
-		if (!y->left->NIL)
-			x = y->left;
+	/* Copies whatever the augmentation keeps in src over to dst. */
+	static void copyAugment(Node_<Type, Augment> *dst, const Node_<Type, Augment> *src) {
+		static_cast<NodeAugment_<Augment>&>(*dst) = static_cast<const NodeAugment_<Augment>&>(*src);
+	}
+
+	/* Trades nodes with other. Each sentinel stays with its tree, so every nil
+	** link is pointed at the new one: O(n + m), no comparisons. */
+	void exchange(Tree& other) {
+		Node_<Type, Augment> *t = root, *first = m_begin, *last = sentinel.parent;
+		size_t n = m_size;
+
+		install(other.root, other.m_begin, other.sentinel.parent, other.m_size);
+		other.install(t, first, last, n);
+	}
+
+	/* Rebuilds the ring of a threaded tree whose shape was set wholesale. */
+	void rethread()	{ Node_<Type, Augment>::rethread(&sentinel, root); }
+
+	Node_<Type, Augment>* getBegin()	{ return m_begin; }
+	Node_<Type, Augment>* getLast()	{ return sentinel.parent; }
+	Node_<Type, Augment>* getEnd()	{ return &sentinel; }
+
+private:
+	void transplant(Node_<Type, Augment> *u, Node_<Type, Augment> *v) {
+		if (!u->parent)
+			root = v;
+		else if (u == u->parent->left)
+			u->parent->left = v;
 		else
-			x = y->right;
+			u->parent->right = v;
+		v->parent = u->parent;
+	}
 
-		x->parent = y->parent;
-		if (y->parent)
-			if (y == y->parent->left)
-				y->parent->left = x;
-			else
-				y->parent->right = x;
+	/* Black nodes from x down to a leaf, x included. */
+	static size_t blackHeight(const Node_<Type, Augment> *x) {
+		size_t h = 0;
+
+		for ( ; !x->isNil(); x = x->left)
+			h += !x->color();
+		return h;
+	}
+
+	/* Takes over a tree built under another sentinel. */
+	void install(Node_<Type, Augment> *t, Node_<Type, Augment> *first, Node_<Type, Augment> *last, size_t n) {
+		if (t->isNil())
+			return reset();
+		root = t;
+		m_begin = first;
+		sentinel.parent = last;
+		m_size = n;
+		relinkNil(t);
+		rethread();
+	}
+
+	void relinkNil(Node_<Type, Augment> *t) {
+		if (t->left->isNil())
+			t->left = &sentinel;
 		else
-			root = x;
-		if (y != z) {
-			delete z->pair;
-			Type *p = new Type(*y->pair);
-			z->pair = p;
+			relinkNil(t->left);
+		if (t->right->isNil())
+			t->right = &sentinel;
+		else
+			relinkNil(t->right);
+	}
+
+	/* Installs t as the whole tree and refreshes the cached extremes. */
+	void settle(Node_<Type, Augment> *t, size_t n) {
+		root = t;
+		m_size = n;
+		if (t->isNil()) {
+			m_begin = sentinel.parent = &sentinel;
+			return;
 		}
+		t->parent = 0;
+		for (m_begin = t; !m_begin->left->isNil(); )
+			m_begin = m_begin->left;
+		for (sentinel.parent = t; !sentinel.parent->right->isNil(); )
+			sentinel.parent = sentinel.parent->right;
+	}
 
-		if (y->color == 0)
-			deleteFixup (x);
-		sentinel.parent = getLast();
-		sentinel.begin = getBegin();
-		m_size--;
-		delete y;
-		return 1;
+	/* Cuts t's children loose as detached trees; a red child is blackened,
+	** which adds one to its black height. */
+	static void detach(Node_<Type, Augment> *t, size_t ht, Node_<Type, Augment> *&a, size_t &ha,
+			Node_<Type, Augment> *&b, size_t &hb) {
+		a = t->left;
+		b = t->right;
+		ha = hb = ht - !t->color();
+		if (!a->isNil()) {
+			a->parent = 0;
+			if (a->color()) { a->setColor(0); ++ha; }
+		}
+		if (!b->isNil()) {
+			b->parent = 0;
+			if (b->color()) { b->setColor(0); ++hb; }
+		}
 	}
 
-	Node_<Type>* getBegin() {
-		Node_<Type>* tmp = root;
-		while (!tmp->left->NIL) {
-			tmp = tmp->left;
+	/* Hangs l and r under k, where every key of l sorts before k and every key
+	** of r after it. k goes red on the spine of the taller tree, where the
+	** black heights meet, and one insert fixup repairs the colours: the cost
+	** is O(|hl - hr| + 1). h gets the black height of the result. */
+	Node_<Type, Augment>* join(Node_<Type, Augment> *l, size_t hl, Node_<Type, Augment> *k,
+			Node_<Type, Augment> *r, size_t hr, size_t &h) {
+		Node_<Type, Augment> *c, *p = 0;
+		size_t hc;
+
+		if (hl == hr) {
+			k->left = l;
+			k->right = r;
+			if (!l->isNil()) l->parent = k;
+			if (!r->isNil()) r->parent = k;
+			k->parent = 0;
+			k->setColor(0);
+			Node_<Type, Augment>::pull(k);
+			h = hl + 1;
+			return k;
+		}
+		if (hl > hr) {
+			for (c = l, hc = hl; hc != hr || c->color(); c = c->right) {
+				hc -= !c->color();
+				p = c;
+			}
+			p->right = k;
+			k->left = c;
+			k->right = r;
+			root = l;
+			h = hl;
+		} else {
+			for (c = r, hc = hr; hc != hl || c->color(); c = c->left) {
+				hc -= !c->color();
+				p = c;
+			}
+			p->left = k;
+			k->left = l;
+			k->right = c;
+			root = r;
+			h = hr;
 		}
-		return tmp;
+		k->parent = p;
+		if (!k->left->isNil()) k->left->parent = k;
+		if (!k->right->isNil()) k->right->parent = k;
+		k->setColor(1);
+		Node_<Type, Augment>::pull(k);
+		Node_<Type, Augment>::adjust(p, Node_<Type, Augment>::size(k) - Node_<Type, Augment>::size(c));
+		h += insertFixup(k);
+		return root;
+	}
+
+	/* join without a middle node: the first node of r takes its place. */
+	Node_<Type, Augment>* join(Node_<Type, Augment> *l, size_t hl, Node_<Type, Augment> *r, size_t hr, size_t &h) {
+		Node_<Type, Augment> *first;
+
+		if (r->isNil()) { h = hl; return l; }
+		if (l->isNil()) { h = hr; return r; }
+		first = splitFirst(r, hr, r, hr);
+		return join(l, hl, first, r, hr, h);
 	}
 
-	Node_<Type>* getLast() {
-		Node_<Type>* tmp = root;
-		while (!tmp->right->NIL) {
-			tmp = tmp->right;
+	/* Splits t into the keys before and after pivot; returns the node of t
+	** equivalent to pivot, cut loose, or NULL. */
+	template <class S, class Less>
+	Node_<Type, Augment>* split(Node_<Type, Augment> *t, size_t ht, S pivot, const Less& less,
+			Node_<Type, Augment> *&l, size_t &hl, Node_<Type, Augment> *&r, size_t &hr) {
+		Node_<Type, Augment> *a, *b, *found, *piece;
+		size_t ha, hb, hp;
+
+		if (t->isNil()) {
+			l = r = &sentinel;
+			hl = hr = 0;
+			return NULL;
+		}
+		detach(t, ht, a, ha, b, hb);
+		if (less(pivot, t)) {
+			found = split(a, ha, pivot, less, l, hl, piece, hp);
+			r = join(piece, hp, t, b, hb, hr);
+		} else if (less(t, pivot)) {
+			found = split(b, hb, pivot, less, piece, hp, r, hr);
+			l = join(a, ha, t, piece, hp, hl);
+		} else {
+			l = a; hl = ha;
+			r = b; hr = hb;
+			found = t;
 		}
-		return tmp;
+		return found;
 	}
 
-	Node_<Type>* getEnd() {
-		Node_<Type>* tmp = root;
-		while (!tmp->right->NIL) {
-			tmp = tmp->right;
+	/* Cuts the first node out of t; rest gets what is left. */
+	Node_<Type, Augment>* splitFirst(Node_<Type, Augment> *t, size_t ht, Node_<Type, Augment> *&rest, size_t &hrest) {
+		Node_<Type, Augment> *a, *b, *first, *piece;
+		size_t ha, hb, hp;
+
+		detach(t, ht, a, ha, b, hb);
+		if (a->isNil()) {
+			rest = b;
+			hrest = hb;
+			return t;
 		}
-		return tmp->right;
+		first = splitFirst(a, ha, piece, hp);
+		rest = join(piece, hp, t, b, hb, hrest);
+		return first;
+	}
+
+	/* Rebuilds the shape and colours of t out of the nodes take hands back. */
+	template <class S, class Take>
+	Node_<Type, Augment>* graft(S t, Take& take, size_t &n) {
+		if (t->isNil()) return &sentinel;
+
+		S a = t->left, b = t->right;
+		bool color = t->color();
+		Node_<Type, Augment> *x = take(t);
+
+		x->setColor(color);
+		x->left = graft(a, take, n);
+		x->right = graft(b, take, n);
+		if (!x->left->isNil()) x->left->parent = x;
+		if (!x->right->isNil()) x->right->parent = x;
+		x->parent = 0;
+		Node_<Type, Augment>::pull(x);
+		++n;
+		return x;
+	}
+
+	/* Hands every node of t to drop; returns how many there were. */
+	template <class Drop>
+	static size_t dropTree(Node_<Type, Augment> *t, Drop& drop) {
+		if (t->isNil()) return 0;
+
+		size_t n = dropTree(t->left, drop) + dropTree(t->right, drop);
+
+		drop(t);
+		return n + 1;
+	}
+
+	/* Black heights of other's subtrees are taken as they stand: h2 counts
+	** its root whatever colour it is. */
+	template <class S, class Less, class Take>
+	Node_<Type, Augment>* uniteTrees(Node_<Type, Augment> *t1, size_t h1, S t2, size_t h2,
+			const Less& less, Take& take, size_t &n, size_t &h) {
+		Node_<Type, Augment> *l, *r, *found, *x;
+		size_t hl, hr, hc;
+
+		if (t2->isNil()) { h = h1; return t1; }
+		if (t1->isNil()) {
+			x = graft(t2, take, n);
+			h = h2;
+			if (x->color()) { x->setColor(0); ++h; }
+			return x;
+		}
+		S a = t2->left, b = t2->right;
+		hc = h2 - !t2->color();
+		found = split(t1, h1, t2, less, l, hl, r, hr);
+		l = uniteTrees(l, hl, a, hc, less, take, n, hl);
+		if (found) {
+			x = take.duplicate(found, t2);
+		} else {
+			x = take(t2);
+			++n;
+		}
+		r = uniteTrees(r, hr, b, hc, less, take, n, hr);
+		return join(l, hl, x, r, hr, h);
+	}
+
+	template <class S, class Less, class Drop>
+	Node_<Type, Augment>* intersectTrees(Node_<Type, Augment> *t1, size_t h1, S t2, size_t h2,
+			const Less& less, Drop& drop, size_t &n, size_t &h) {
+		Node_<Type, Augment> *l, *r, *found;
+		size_t hl, hr;
+
+		if (t1->isNil()) { h = 0; return t1; }
+		if (t2->isNil()) {
+			dropTree(t1, drop);
+			h = 0;
+			return &sentinel;
+		}
+		found = split(t1, h1, t2, less, l, hl, r, hr);
+		l = intersectTrees(l, hl, t2->left, h2 - !t2->color(), less, drop, n, hl);
+		r = intersectTrees(r, hr, t2->right, h2 - !t2->color(), less, drop, n, hr);
+		if (!found)
+			return join(l, hl, r, hr, h);
+		++n;
+		return join(l, hl, found, r, hr, h);
+	}
+
+	template <class S, class Less, class Drop>
+	Node_<Type, Augment>* subtractTrees(Node_<Type, Augment> *t1, size_t h1, S t2, size_t h2,
+			const Less& less, Drop& drop, size_t &n, size_t &h) {
+		Node_<Type, Augment> *l, *r, *found;
+		size_t hl, hr;
+
+		if (t1->isNil() || t2->isNil()) { h = h1; return t1; }
+		found = split(t1, h1, t2, less, l, hl, r, hr);
+		if (found) {
+			drop(found);
+			--n;
+		}
+		l = subtractTrees(l, hl, t2->left, h2 - !t2->color(), less, drop, n, hl);
+		r = subtractTrees(r, hr, t2->right, h2 - !t2->color(), less, drop, n, hr);
+		return join(l, hl, r, hr, h);
+	}
+
+	struct BuildPiece_ {
+		Tree					*tree;
+		Node_<Type, Augment>	**pieces;
+		const size_t			*sizes;
+		Node_<Type, Augment>	**roots;
+		size_t					cut;
+		size_t					red;
+
+		void operator()(size_t i) const {
+			size_t next = 0;
+			roots[i] = tree->buildRun(pieces[i], sizes[i], cut, red, (size_t)-1, NULL, next);
+		}
+	};
+
+	/* The subarrays found at depth cut of the recursion buildRun makes. */
+	static void cutRun(Node_<Type, Augment> *run, size_t n, size_t depth, size_t cut,
+			ft::Vector<Node_<Type, Augment>*> &pieces, ft::Vector<size_t> &sizes) {
+		if (!n) return;
+		if (depth == cut) {
+			pieces.push_back(run);
+			sizes.push_back(n);
+			return;
+		}
+		cutRun(run, (n - 1) / 2, depth + 1, cut, pieces, sizes);
+		cutRun(run + (n - 1) / 2 + 1, n - 1 - (n - 1) / 2, depth + 1, cut, pieces, sizes);
+	}
+
+	/* buildRange over an array; subtrees at depth cut are taken ready built
+	** from roots, in order. */
+	Node_<Type, Augment>* buildRun(Node_<Type, Augment> *run, size_t n, size_t depth, size_t red, size_t cut,
+			Node_<Type, Augment> **roots, size_t &next) {
+		if (!n) return &sentinel;
+		if (depth == cut) return roots[next++];
+
+		Node_<Type, Augment> *x = run + (n - 1) / 2;
+
+		x->left = buildRun(run, (n - 1) / 2, depth + 1, red, cut, roots, next);
+		if (!x->left->isNil()) x->left->parent = x;
+		x->right = buildRun(x + 1, n - 1 - (n - 1) / 2, depth + 1, red, cut, roots, next);
+		if (!x->right->isNil()) x->right->parent = x;
+		x->setColor(depth == red);
+		Node_<Type, Augment>::pull(x);
+		return x;
+	}
+
+	Node_<Type, Augment>* buildRange(Node_<Type, Augment> *&head, size_t n, size_t depth, size_t red) {
+		if (!n) return &sentinel;
+
+		Node_<Type, Augment> *left = buildRange(head, (n - 1) / 2, depth + 1, red);
+		Node_<Type, Augment> *x = head;
+
+		head = head->right;
+		Node_<Type, Augment>::linkBefore(x, &sentinel);
+		x->left = left;
+		if (!left->isNil()) left->parent = x;
+		x->right = buildRange(head, n - 1 - (n - 1) / 2, depth + 1, red);
+		if (!x->right->isNil()) x->right->parent = x;
+		x->setColor(depth == red);
+		Node_<Type, Augment>::pull(x);
+		return x;
 	}
 };
 
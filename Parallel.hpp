@@ -0,0 +1,210 @@
+#pragma once
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+# include <algorithm>
+# include <atomic>
+# include <cstddef>
+# include <exception>
+# include <mutex>
+# include <thread>
+# include "Vector.hpp"
+
+namespace ft {
+	/* Below this many elements per thread, splitting work costs more than
+	** it saves. */
+	const std::size_t parallel_grain = 4096;
+
+	template <class Job>
+	struct ParallelWorker_ {
+		const Job&					job;
+		std::size_t					count;
+		std::atomic<std::size_t>&	next;
+		std::exception_ptr&			error;
+		std::mutex&					error_lock;
+
+		void operator()() const {
+			for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count; ) {
+				try {
+					job(i);
+				} catch (...) {
+					std::lock_guard<std::mutex> lock(error_lock);
+					if (!error) error = std::current_exception();
+					next.store(count, std::memory_order_relaxed);
+				}
+			}
+		}
+	};
+
+	/* The thread count to use for count jobs when threads were asked for,
+	** 0 meaning one per core. */
+	inline unsigned parallel_threads(std::size_t count, unsigned threads) {
+		if (!threads)
+			threads = std::thread::hardware_concurrency();
+		if (threads > count)
+			threads = static_cast<unsigned>(count);
+		return threads ? threads : 1;
+	}
+
+	/*
+	** Runs job(i) for every i below count on up to threads threads, 0 meaning
+	** one per core; the calling thread is one of them. Indices come off a
+	** shared counter, so uneven jobs balance out. The first exception thrown
+	** by a job stops the handing out of indices and is rethrown here once
+	** every thread has stopped.
+	*/
+	template <class Job>
+	void parallel_for(std::size_t count, unsigned threads, const Job& job) {
+		std::atomic<std::size_t>	next(0);
+		std::exception_ptr			error;
+		std::mutex					error_lock;
+		ft::Vector<std::thread>		workers;
+		ParallelWorker_<Job>		work = { job, count, next, error, error_lock };
+
+		threads = parallel_threads(count, threads);
+		for (unsigned t = 1; t < threads; ++t)
+			workers.push_back(std::thread(work));
+		work();
+		for (std::size_t t = 0; t < workers.size(); ++t)
+			workers[t].join();
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+	/* One slice of a pairwise merge, or a lone run copied over. */
+	template <class T>
+	struct MergeSlice_ {
+		const T	*a, *a_end, *b, *b_end;
+		T		*out;
+	};
+
+	template <class T, class Compare>
+	struct SortRun_ {
+		T					*first;
+		const std::size_t	*bounds;
+		const Compare		&comp;
+		void operator()(std::size_t i) const { std::stable_sort(first + bounds[i], first + bounds[i + 1], comp); }
+	};
+
+	template <class T, class Compare>
+	struct MergeRun_ {
+		const MergeSlice_<T>	*slices;
+		const Compare			&comp;
+		void operator()(std::size_t i) const {
+			const MergeSlice_<T>& s = slices[i];
+			std::merge(s.a, s.a_end, s.b, s.b_end, s.out, comp);
+		}
+	};
+
+	/*
+	** Stable sort on up to threads threads, 0 meaning one per core: equal
+	** slices are sorted apart, then merged pairwise round after round. Each
+	** merge is cut into as many slices as there are threads to spare, at
+	** splitters taken from the left run and looked up in the right one with
+	** lower_bound, so that equal elements keep their order. Needs a buffer
+	** as large as the input.
+	*/
+	template <class T, class Compare>
+	void parallel_stable_sort(T *first, T *last, const Compare& comp, unsigned threads) {
+		std::size_t						n = last - first, runs;
+		ft::Vector<std::size_t>			bounds;
+		ft::Vector<MergeSlice_<T> >		slices;
+		T								*src = first, *dst;
+
+		threads = parallel_threads(n / parallel_grain, threads);
+		if (threads < 2) {
+			std::stable_sort(first, last, comp);
+			return;
+		}
+		for (std::size_t i = 0; i <= threads; ++i)
+			bounds.push_back(n * i / threads);
+		SortRun_<T, Compare> sort = { first, bounds.data(), comp };
+		parallel_for(threads, threads, sort);
+
+		ft::Vector<T> buffer(n);
+		dst = buffer.data();
+		for (runs = threads; runs > 1; runs = (runs + 1) / 2) {
+			std::size_t parts = std::max<std::size_t>(1, threads / (runs / 2));
+			slices.clear();
+			for (std::size_t r = 0; r + 1 < runs; r += 2) {
+				std::size_t lo = bounds[r], mid = bounds[r + 1], hi = bounds[r + 2];
+				const T *a = src + lo, *b = src + mid;
+				for (std::size_t p = 1; p <= parts; ++p) {
+					const T *a_end = p == parts ? src + mid : src + lo + (mid - lo) * p / parts;
+					const T *b_end = p == parts ? src + hi : std::lower_bound(b, static_cast<const T*>(src + hi), *a_end, comp);
+					MergeSlice_<T> s = { a, a_end, b, b_end, dst + (a - src) + (b - (src + mid)) };
+					slices.push_back(s);
+					a = a_end;
+					b = b_end;
+				}
+			}
+			if (runs % 2) {
+				MergeSlice_<T> s = { src + bounds[runs - 1], src + bounds[runs], src + n, src + n, dst + bounds[runs - 1] };
+				slices.push_back(s);
+			}
+			MergeRun_<T, Compare> merge = { slices.data(), comp };
+			parallel_for(slices.size(), threads, merge);
+			for (std::size_t r = 0; 2 * r < runs; ++r)
+				bounds[r] = bounds[2 * r];
+			bounds[(runs + 1) / 2] = n;
+			std::swap(src, dst);
+		}
+		if (src != first)
+			std::copy(src, src + n, first);
+	}
+
+	/* Element i is kept when it is the first or sorts after the one before. */
+	template <class T, class Compare>
+	struct UniqueCount_ {
+		const T				*first;
+		const std::size_t	*bounds;
+		std::size_t			*counts;
+		const Compare		&comp;
+		void operator()(std::size_t b) const {
+			std::size_t kept = 0;
+			for (std::size_t i = bounds[b]; i < bounds[b + 1]; ++i)
+				kept += !i || comp(first[i - 1], first[i]);
+			counts[b] = kept;
+		}
+	};
+
+	template <class T, class Compare>
+	struct UniqueCopy_ {
+		const T				*first;
+		const std::size_t	*bounds;
+		const std::size_t	*offsets;
+		T					*out;
+		const Compare		&comp;
+		void operator()(std::size_t b) const {
+			T *o = out + offsets[b];
+			for (std::size_t i = bounds[b]; i < bounds[b + 1]; ++i)
+				if (!i || comp(first[i - 1], first[i]))
+					*o++ = first[i];
+		}
+	};
+
+	/* Copies [first, last), sorted by comp, to out but for the elements
+	** equivalent to the one before them; returns how many it copied. Each
+	** thread counts what its slice keeps, then writes it out after what the
+	** slices before keep. */
+	template <class T, class Compare>
+	std::size_t parallel_unique_copy(const T *first, const T *last, T *out, const Compare& comp, unsigned threads) {
+		std::size_t					n = last - first;
+		ft::Vector<std::size_t>		bounds, counts, offsets;
+
+		threads = parallel_threads(n / parallel_grain, threads);
+		for (std::size_t i = 0; i <= threads; ++i)
+			bounds.push_back(n * i / threads);
+		counts.resize(threads);
+		UniqueCount_<T, Compare> count = { first, bounds.data(), counts.data(), comp };
+		parallel_for(threads, threads, count);
+		offsets.push_back(0);
+		for (std::size_t b = 0; b < threads; ++b)
+			offsets.push_back(offsets[b] + counts[b]);
+		UniqueCopy_<T, Compare> copy = { first, bounds.data(), offsets.data(), out, comp };
+		parallel_for(threads, threads, copy);
+		return offsets[threads];
+	}
+}
+
+#endif
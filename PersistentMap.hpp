@@ -0,0 +1,509 @@
+#pragma once
+#ifndef PERSISTENT_MAP_HPP
+#define PERSISTENT_MAP_HPP
+
+# include <atomic>
+# include <cstddef>
+# include <functional>
+# include <limits>
+# include <memory>
+# include <new>
+# include <stdexcept>
+# include <type_traits>
+# include <utility>
+# include "Iterator.hpp"
+# include "Utility.hpp"
+
+namespace ft {
+	/*
+	** Ordered map whose copies share structure: a red-black tree of reference
+	** counted nodes without parent links. Copying, and so snapshot(), only
+	** takes a reference to the root, O(1). A write copies the nodes on its
+	** path that some other version still references and changes the rest in
+	** place, so with no snapshot alive it costs what an ft::Map write does,
+	** and with one alive it copies O(log n) nodes. Rebalancing runs the same
+	** cases as Tree::insertFixup and Tree::deleteFixup, on a stack of the
+	** ancestors instead of parent links.
+	**
+	** A version is never changed once another one shares its nodes, so a
+	** snapshot handed to another thread can be read there without locks
+	** while this map keeps being written; dropping it from that thread is
+	** safe too. A single version is not for concurrent use, and iterators
+	** into one are invalidated by its next write. Values are only reachable
+	** as const: mapped values change through insert_or_assign.
+	*/
+	template <class Key, class T, class Compare = std::less<Key>, class A = std::allocator<ft::pair<const Key, T> > >
+	class PersistentMap {
+	public:
+		typedef Key																	key_type;
+		typedef T																	mapped_type;
+		typedef ft::pair<const Key, T>												value_type;
+		typedef std::size_t															size_type;
+		typedef std::ptrdiff_t														difference_type;
+		typedef Compare																key_compare;
+		typedef A																	allocator_type;
+		typedef value_type&															reference;
+		typedef const value_type&													const_reference;
+
+	private:
+		/* colour is 1 for red and 0 for black, as in Node_; a null child
+		** stands for the black leaves. refs counts the parents and maps
+		** pointing at the node. */
+		struct Node_ {
+			Node_						*left;
+			Node_						*right;
+			std::atomic<size_type>		refs;
+			int							color;
+			typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type	storage;
+
+			Node_(): left(NULL), right(NULL), refs(1), color(1) {}
+			value_type&	value()		{ return *reinterpret_cast<value_type*>(&storage); }
+			const Key&	key()		{ return value().first; }
+		};
+
+		/* A red-black tree of n nodes is at most 2 log2(n + 1) high. */
+		static const std::size_t	_max_depth = 2 * std::numeric_limits<size_type>::digits;
+
+	public:
+		typedef ft::PathIterator<Node_, const value_type, _max_depth>				const_iterator;
+		typedef const_iterator														iterator;
+		typedef typename allocator_type::template rebind<Node_>::other				allocator_rebind_node;
+
+	private:
+		allocator_rebind_node		_allocator_rebind_node;
+		Compare						_comp;
+		Node_						*_root;
+		size_type					_size;
+
+	public:
+		/**************************** Constructors ****************************/
+		explicit PersistentMap(const Compare& comp = Compare(), const A& alloc = A())
+			: _allocator_rebind_node(alloc), _comp(comp), _root(NULL), _size(0) {}
+
+		template <class InputIt>
+		PersistentMap(InputIt first, InputIt last, const Compare& comp = Compare(), const A& alloc = A())
+			: _allocator_rebind_node(alloc), _comp(comp), _root(NULL), _size(0) {
+			insert(first, last);
+		}
+
+		PersistentMap(const PersistentMap& other)
+			: _allocator_rebind_node(other._allocator_rebind_node), _comp(other._comp), _root(retain(other._root)),
+			_size(other._size) {}
+
+		PersistentMap(PersistentMap&& other)
+			: _allocator_rebind_node(other._allocator_rebind_node), _comp(other._comp), _root(other._root), _size(other._size) {
+			other._root = NULL;
+			other._size = 0;
+		}
+
+		PersistentMap& operator=(const PersistentMap& other) {
+			Node_ *old = _root;
+
+			_root = retain(other._root);
+			_size = other._size;
+			_comp = other._comp;
+			release(old);
+			return *this;
+		}
+
+		PersistentMap& operator=(PersistentMap&& other) {
+			if (this == &other)
+				return *this;
+			clear();
+			swap(other);
+			return *this;
+		}
+
+		~PersistentMap() { release(_root); }
+
+		/*************************** Members Methods **************************/
+		allocator_type		get_allocator() const	{ return allocator_type(_allocator_rebind_node); }
+		key_compare			key_comp() const		{ return _comp; }
+		bool				empty() const			{ return _size == 0; }
+		size_type			size() const			{ return _size; }
+		size_type			max_size() const		{ return std::numeric_limits<difference_type>::max() / sizeof(Node_); }
+
+		/* The current version, frozen: later writes to this map copy the
+		** nodes they touch instead of changing the snapshot's. */
+		PersistentMap		snapshot() const		{ return *this; }
+
+		const_iterator begin() const {
+			const_iterator it;
+
+			it.pushLeftmost(_root);
+			return it;
+		}
+		const_iterator		end() const				{ return const_iterator(); }
+
+		void clear() {
+			release(_root);
+			_root = NULL;
+			_size = 0;
+		}
+
+		void swap( PersistentMap& other ) {
+			std::swap(_allocator_rebind_node, other._allocator_rebind_node);
+			std::swap(_comp, other._comp);
+			std::swap(_root, other._root);
+			std::swap(_size, other._size);
+		}
+
+		ft::pair<const_iterator, bool> insert( const value_type& value ) {
+			if (findNode(value.first))
+				return ft::pair<const_iterator, bool>(find(value.first), false);
+			linkNode(value.first, value);
+			return ft::pair<const_iterator, bool>(find(value.first), true);
+		}
+
+		ft::pair<const_iterator, bool> insert( value_type&& value ) {
+			if (findNode(value.first))
+				return ft::pair<const_iterator, bool>(find(value.first), false);
+			linkNode(value.first, std::move(value));
+			return ft::pair<const_iterator, bool>(find(value.first), true);
+		}
+
+		template <class InputIt>
+		void insert( InputIt first, InputIt last ) {
+			for ( ; first != last; ++first)
+				if (!findNode(first->first))
+					linkNode(first->first, first->first, first->second);
+		}
+
+		/* Overwrites the mapped value of an existing key on a copy of its
+		** path when the path is shared. */
+		template <class M>
+		ft::pair<const_iterator, bool> insert_or_assign( const Key& key, M&& obj ) {
+			bool inserted = true;
+
+			if (findNode(key)) {
+				Node_ *path[_max_depth];
+				std::size_t depth = ownPath(key, path);
+				path[depth - 1]->value().second = std::forward<M>(obj);
+				inserted = false;
+			} else {
+				linkNode(key, key, std::forward<M>(obj));
+			}
+			return ft::pair<const_iterator, bool>(find(key), inserted);
+		}
+
+		size_type erase( const Key& key ) {
+			if (!findNode(key))
+				return 0;
+			unlinkNode(key);
+			return 1;
+		}
+
+		const_iterator find( const Key& key ) const {
+			const_iterator it = lower_bound(key);
+
+			return it == end() || _comp(key, it->first) ? end() : it;
+		}
+
+		size_type	count( const Key& key ) const		{ return findNode(key) ? 1 : 0; }
+
+		const T& at( const Key& key ) const {
+			Node_ *x = findNode(key);
+
+			if (!x)
+				throw std::out_of_range("PersistentMap::at: key not found");
+			return x->value().second;
+		}
+
+		/* The stack only keeps the nodes left behind by going left, which
+		** are exactly those still to be visited. */
+		const_iterator lower_bound( const Key& key ) const {
+			const_iterator it;
+
+			for (Node_ *x = _root; x; )
+				if (_comp(x->key(), key)) {
+					x = x->right;
+				} else {
+					it.push(x);
+					x = x->left;
+				}
+			return it;
+		}
+
+		const_iterator upper_bound( const Key& key ) const {
+			const_iterator it;
+
+			for (Node_ *x = _root; x; )
+				if (_comp(key, x->key())) {
+					it.push(x);
+					x = x->left;
+				} else {
+					x = x->right;
+				}
+			return it;
+		}
+
+		ft::pair<const_iterator, const_iterator> equal_range( const Key& key ) const {
+			return ft::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+		}
+
+	private:
+		static bool isRed(Node_ *x) { return x && x->color == 1; }
+
+		static Node_* retain(Node_ *x) {
+			if (x) x->refs.fetch_add(1, std::memory_order_relaxed);
+			return x;
+		}
+
+		/* The last reference frees the node and lets go of its children;
+		** a reader dropping a snapshot may be the one to get there. */
+		void release(Node_ *x) {
+			while (x && x->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				Node_ *right = x->right;
+
+				release(x->left);
+				destroyNode(x);
+				x = right;
+			}
+		}
+
+		template <class... Args>
+		Node_* createNode(Args&&... args) {
+			Node_ *x = _allocator_rebind_node.allocate(1);
+
+			new (x) Node_();
+			try {
+				new (&x->storage) value_type(std::forward<Args>(args)...);
+			} catch (...) {
+				x->~Node_();
+				_allocator_rebind_node.deallocate(x, 1);
+				throw;
+			}
+			return x;
+		}
+
+		void destroyNode(Node_ *x) {
+			x->value().~value_type();
+			x->~Node_();
+			_allocator_rebind_node.deallocate(x, 1);
+		}
+
+		/*
+		** Makes the node in slot private to this version: one nobody else
+		** references is used as is, otherwise the slot gets a copy that
+		** shares its children. Only ever called on a slot of a node already
+		** owned, or on the root, so a count of one cannot rise under us.
+		*/
+		Node_* own(Node_ *&slot) {
+			Node_ *x = slot;
+
+			if (x->refs.load(std::memory_order_acquire) == 1)
+				return x;
+			slot = createNode(x->value());
+			slot->left = retain(x->left);
+			slot->right = retain(x->right);
+			slot->color = x->color;
+			release(x);
+			return slot;
+		}
+
+		Node_** slotOf(Node_ **path, std::size_t i) {
+			if (!i) return &_root;
+			return path[i - 1]->left == path[i] ? &path[i - 1]->left : &path[i - 1]->right;
+		}
+
+		static void rotateLeft(Node_ *&slot) {
+			Node_ *x = slot, *y = x->right;
+
+			x->right = y->left;
+			y->left = x;
+			slot = y;
+		}
+
+		static void rotateRight(Node_ *&slot) {
+			Node_ *x = slot, *y = x->left;
+
+			x->left = y->right;
+			y->right = x;
+			slot = y;
+		}
+
+		template <class K>
+		Node_* findNode(const K& key) const {
+			Node_ *x = _root;
+
+			while (x && (_comp(key, x->key()) || _comp(x->key(), key)))
+				x = _comp(key, x->key()) ? x->left : x->right;
+			return x;
+		}
+
+		/* Owns every node from the root down to key, which is present, and
+		** returns how many there are. */
+		std::size_t ownPath(const Key& key, Node_ **path) {
+			std::size_t	depth = 0;
+			Node_		**slot = &_root;
+
+			for (;;) {
+				Node_ *x = own(*slot);
+				path[depth++] = x;
+				if (_comp(key, x->key()))
+					slot = &x->left;
+				else if (_comp(x->key(), key))
+					slot = &x->right;
+				else
+					return depth;
+			}
+		}
+
+		/* key is absent: owns the path down to its leaf, hangs a red node
+		** there and runs insertFixup's cases up the path. */
+		template <class... Args>
+		void linkNode(const Key& key, Args&&... args) {
+			Node_		*path[_max_depth + 1];
+			std::size_t	i = 0;
+			Node_		**slot = &_root;
+
+			while (*slot) {
+				Node_ *x = own(*slot);
+				path[i++] = x;
+				slot = _comp(key, x->key()) ? &x->left : &x->right;
+			}
+			*slot = createNode(std::forward<Args>(args)...);
+			path[i] = *slot;
+			++_size;
+			while (i >= 2 && isRed(path[i - 1])) {
+				Node_ *x = path[i], *p = path[i - 1], *g = path[i - 2];
+				if (p == g->left) {
+					if (isRed(g->right)) {
+						p->color = 0;
+						own(g->right)->color = 0;
+						g->color = 1;
+						i -= 2;
+						continue;
+					}
+					if (x == p->right)
+						rotateLeft(g->left);
+					g->left->color = 0;
+					g->color = 1;
+					rotateRight(*slotOf(path, i - 2));
+				} else {
+					if (isRed(g->left)) {
+						p->color = 0;
+						own(g->left)->color = 0;
+						g->color = 1;
+						i -= 2;
+						continue;
+					}
+					if (x == p->left)
+						rotateRight(g->right);
+					g->right->color = 0;
+					g->color = 1;
+					rotateLeft(*slotOf(path, i - 2));
+				}
+				break;
+			}
+			_root->color = 0;
+		}
+
+		/*
+		** key is present: owns its path, and when its node has two children
+		** the path on to its successor, whose value moves up in its place.
+		** The node left with at most one child is spliced out, and a black
+		** one leaves a black deficit that deleteFixup's cases push up the
+		** path. Siblings are owned before they are recoloured or rotated.
+		*/
+		void unlinkNode(const Key& key) {
+			Node_		*path[_max_depth + 2];
+			std::size_t	i = ownPath(key, path);
+			Node_		*z = path[i - 1], *y, *x;
+			Node_		**slot;
+
+			if (z->left && z->right) {
+				slot = &z->right;
+				while (*slot) {
+					path[i++] = own(*slot);
+					slot = &path[i - 1]->left;
+				}
+				y = path[i - 1];
+				z->value().~value_type();
+				new (&z->storage) value_type(std::move(y->value()));
+			}
+			y = path[--i];
+			x = y->left ? y->left : y->right;
+			slot = slotOf(path, i);
+			*slot = x;
+			y->left = y->right = NULL;
+			if (y->color == 0) {
+				if (isRed(x))
+					own(*slot)->color = 0;
+				else
+					deleteFixup(path, i, i && slot == &path[i - 1]->left);
+			}
+			release(y);
+			--_size;
+		}
+
+		/* The subtree at depth i, on the left of path[i - 1] or not, is one
+		** black short. */
+		void deleteFixup(Node_ **path, std::size_t i, bool left) {
+			while (i) {
+				Node_ *p = path[i - 1], *w;
+				if (left) {
+					w = own(p->right);
+					if (w->color == 1) {
+						w->color = 0;
+						p->color = 1;
+						rotateLeft(*slotOf(path, i - 1));
+						path[i - 1] = w;
+						path[i++] = p;
+						w = own(p->right);
+					}
+					if (!isRed(w->left) && !isRed(w->right)) {
+						w->color = 1;
+					} else {
+						if (!isRed(w->right)) {
+							own(w->left)->color = 0;
+							w->color = 1;
+							rotateRight(p->right);
+							w = p->right;
+						}
+						w->color = p->color;
+						p->color = 0;
+						own(w->right)->color = 0;
+						rotateLeft(*slotOf(path, i - 1));
+						break;
+					}
+				} else {
+					w = own(p->left);
+					if (w->color == 1) {
+						w->color = 0;
+						p->color = 1;
+						rotateRight(*slotOf(path, i - 1));
+						path[i - 1] = w;
+						path[i++] = p;
+						w = own(p->left);
+					}
+					if (!isRed(w->right) && !isRed(w->left)) {
+						w->color = 1;
+					} else {
+						if (!isRed(w->left)) {
+							own(w->right)->color = 0;
+							w->color = 1;
+							rotateLeft(p->left);
+							w = p->left;
+						}
+						w->color = p->color;
+						p->color = 0;
+						own(w->left)->color = 0;
+						rotateRight(*slotOf(path, i - 1));
+						break;
+					}
+				}
+				if (p->color == 1) {
+					p->color = 0;
+					break;
+				}
+				--i;
+				left = i && path[i - 1]->left == p;
+			}
+			if (_root)
+				_root->color = 0;
+		}
+	};
+}
+
+#endif
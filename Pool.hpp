@@ -0,0 +1,309 @@
+#pragma once
+#ifndef POOL_HPP
+#define POOL_HPP
+
+# include <memory>
+# include <algorithm>
+# include <atomic>
+# include <cstddef>
+# include <new>
+# include "Vector.hpp"
+
+namespace ft {
+	/*
+	** Hands out nodes from contiguous slabs. Freed nodes go to an intrusive
+	** free list, untouched slab space is handed out with a bump pointer, and
+	** release() gives every slab back to the allocator at once.
+	**
+	** Nodes may change pools one at a time. Every slab counts its holders:
+	** the pool that made it, each other pool holding some of its nodes, and
+	** each node handle. take() moves a node out under a claim, give() moves
+	** a claimed node in, and drop() sends the slot of a handle's node back to
+	** the pool it was taken from, through a lock-free inbox that pool empties
+	** when it runs out of free nodes. A slab goes back to the allocator once
+	** no one holds it. Counts are atomic, so pools in different threads may
+	** trade nodes as long as each pool has one user at a time.
+	*/
+	template <class Node, class A = std::allocator<Node> >
+	class NodePool {
+		struct Slab_ {
+			std::size_t					count;
+			std::atomic<std::size_t>	refs;
+
+			explicit Slab_(std::size_t n): count(n), refs(1) {}
+		};
+
+		/* slab is only set on nodes sent back through a home's inbox. */
+		struct FreeNode_ { FreeNode_ *next; Slab_ *slab; };
+
+		/* Where handles send their slots. A pool being destroyed closes the
+		** inbox by storing the home itself as its head. */
+		struct Home_ {
+			std::atomic<FreeNode_*>		inbox;
+			std::atomic<std::size_t>	refs;
+
+			Home_(): inbox(0), refs(1) {}
+			FreeNode_*	closed()	{ return reinterpret_cast<FreeNode_*>(this); }
+		};
+
+		/* A slab this pool holds nodes of; slots counts them when another
+		** pool made it, and is 0 for the pool's own slabs. */
+		struct Held_ { Node *first; Node *last; Slab_ *slab; std::size_t slots; };
+
+		typedef ft::Vector<Held_, typename A::template rebind<Held_>::other>	held_container;
+
+		static const std::size_t	_min_slab = 16;
+		static const std::size_t	_max_slab = 4096;
+
+		A							_allocator;
+		held_container				_held;
+		Home_						*_home;
+		FreeNode_					*_free;
+		Node						*_cursor;
+		Node						*_limit;
+		std::size_t					_available;
+		std::size_t					_next_slab;
+
+		NodePool(const NodePool& other);
+		NodePool& operator=(const NodePool& other);
+
+	public:
+		typedef std::size_t			size_type;
+
+		/* One node out of its pool: a hold on its slab and on the home it
+		** goes back to. */
+		struct claim_type { Slab_ *slab; Home_ *home; };
+
+		/**************************** Constructors ****************************/
+		explicit NodePool(const A& alloc = A())
+			: _allocator(alloc), _home(0), _free(0), _cursor(0), _limit(0), _available(0), _next_slab(_min_slab) {}
+
+		~NodePool() {
+			release();
+			if (!_home) return;
+			for (FreeNode_ *x = _home->inbox.exchange(_home->closed(), std::memory_order_acquire); x; x = x->next)
+				unref(x->slab, _allocator);
+			unhome(_home);
+		}
+
+		/*************************** Members Methods **************************/
+		Node* allocate() {
+			if (!_free && _home && _home->inbox.load(std::memory_order_relaxed))
+				collectInbox();
+			if (_free) {
+				Node *node = reinterpret_cast<Node*>(_free);
+				_free = _free->next;
+				--_available;
+				return node;
+			}
+			if (_cursor == _limit)
+				grow(_next_slab);
+			--_available;
+			return _cursor++;
+		}
+
+		/* count nodes lying next to each other in one slab, as bulk builds
+		** want them; the rest of the current slab stays in use when it can
+		** hold them. Hand them back one at a time with deallocate. */
+		Node* allocateRun(size_type count) {
+			Node *run;
+
+			if (static_cast<size_type>(_limit - _cursor) < count)
+				grow(count);
+			run = _cursor;
+			_cursor += count;
+			_available -= count;
+			return run;
+		}
+
+		void deallocate(Node *node) {
+			FreeNode_ *tmp = reinterpret_cast<FreeNode_*>(node);
+			tmp->next = _free;
+			_free = tmp;
+			++_available;
+		}
+
+		void reserve(size_type count) {
+			if (count > _available)
+				grow(count - _available);
+		}
+
+		/* Lets go of every slab held; those with nodes still out in handles
+		** or other pools stay until the last of them comes back. */
+		void release() {
+			if (_home) {
+				for (FreeNode_ *x = _home->inbox.exchange(0, std::memory_order_acquire); x; x = x->next)
+					unref(x->slab, _allocator);
+			}
+			for (size_type i = 0; i < _held.size(); ++i)
+				unref(_held[i].slab, _allocator);
+			_held.clear();
+			_free = 0;
+			_cursor = _limit = 0;
+			_available = 0;
+			_next_slab = _min_slab;
+		}
+
+		void swap(NodePool& other) {
+			std::swap(_allocator, other._allocator);
+			_held.swap(other._held);
+			std::swap(_home, other._home);
+			std::swap(_free, other._free);
+			std::swap(_cursor, other._cursor);
+			std::swap(_limit, other._limit);
+			std::swap(_available, other._available);
+			std::swap(_next_slab, other._next_slab);
+		}
+
+		/* node, in use, leaves this pool for a node handle. */
+		claim_type take(Node *node) {
+			claim_type claim;
+
+			if (!_home)
+				_home = new Home_();
+			claim.slab = detach(node);
+			claim.home = _home;
+			_home->refs.fetch_add(1, std::memory_order_relaxed);
+			return claim;
+		}
+
+		/* A claimed node joins this pool. */
+		void give(Node *node, claim_type claim) {
+			attach(node, claim.slab);
+			unhome(claim.home);
+		}
+
+		/* Moves node, in use, over from other without a claim. */
+		void transfer(Node *node, NodePool& other) {
+			if (&other != this)
+				attach(node, other.detach(node));
+		}
+
+		/* The claimed node's value is gone: its slot goes back to the pool it
+		** was taken from, or lets go of its slab if that pool is gone. */
+		static void drop(Node *node, claim_type claim, A alloc) {
+			FreeNode_ *slot = reinterpret_cast<FreeNode_*>(node);
+			FreeNode_ *head = claim.home->inbox.load(std::memory_order_relaxed);
+
+			slot->slab = claim.slab;
+			do {
+				if (head == claim.home->closed()) {
+					unref(claim.slab, alloc);
+					break;
+				}
+				slot->next = head;
+			} while (!claim.home->inbox.compare_exchange_weak(head, slot, std::memory_order_release, std::memory_order_relaxed));
+			unhome(claim.home);
+		}
+
+		size_type available() const { return _available; }
+
+	private:
+		static void unref(Slab_ *slab, A& alloc) {
+			if (slab->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+			std::size_t count = slab->count;
+			slab->~Slab_();
+			alloc.deallocate(reinterpret_cast<Node*>(slab), count + 1);
+		}
+
+		static void unhome(Home_ *home) {
+			if (home->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				delete home;
+		}
+
+		/* The held slab node lies in; binary search on the slab starts. */
+		size_type find(const Node *node) const {
+			size_type lo = 0, hi = _held.size();
+
+			while (lo < hi) {
+				size_type mid = (lo + hi) / 2;
+				if (_held[mid].first <= node)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			return (lo && node < _held[lo - 1].last) ? lo - 1 : _held.size();
+		}
+
+		void hold(const Held_& held) {
+			size_type i = _held.size();
+
+			_held.push_back(held);
+			for ( ; i && held.first < _held[i - 1].first; --i)
+				_held[i] = _held[i - 1];
+			_held[i] = held;
+		}
+
+		/* Counts node out of this pool; the caller gets a hold on its slab. */
+		Slab_* detach(Node *node) {
+			size_type i = find(node);
+			Slab_ *slab = _held[i].slab;
+
+			if (_held[i].slots == 1) {
+				for ( ; i + 1 < _held.size(); ++i)
+					_held[i] = _held[i + 1];
+				_held.pop_back();
+				return slab;
+			}
+			if (_held[i].slots)
+				--_held[i].slots;
+			slab->refs.fetch_add(1, std::memory_order_relaxed);
+			return slab;
+		}
+
+		/* Counts node in, taking over the caller's hold on slab. */
+		void attach(Node *node, Slab_ *slab) {
+			size_type i = find(node);
+
+			if (i == _held.size()) {
+				Held_ held = { reinterpret_cast<Node*>(slab) + 1, reinterpret_cast<Node*>(slab) + 1 + slab->count, slab, 1 };
+				hold(held);
+				return;
+			}
+			if (_held[i].slots)
+				++_held[i].slots;
+			slab->refs.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		/* Takes in the slots handles sent back. */
+		void collectInbox() {
+			FreeNode_ *x = _home->inbox.exchange(0, std::memory_order_acquire);
+
+			while (x) {
+				FreeNode_ *next = x->next;
+				attach(reinterpret_cast<Node*>(x), x->slab);
+				deallocate(reinterpret_cast<Node*>(x));
+				x = next;
+			}
+		}
+
+		/* Moves the untouched rest of the current slab onto the free list. */
+		void retireCursor() {
+			for ( ; _cursor != _limit; ++_cursor) {
+				FreeNode_ *tmp = reinterpret_cast<FreeNode_*>(_cursor);
+				tmp->next = _free;
+				_free = tmp;
+			}
+			_cursor = _limit = 0;
+		}
+
+		void grow(size_type count) {
+			static_assert(sizeof(Node) >= sizeof(Slab_) && sizeof(Node) >= sizeof(FreeNode_), "node is too small to hold a slab header");
+			if (count < _next_slab)
+				count = _next_slab;
+			retireCursor();
+			_held.reserve(_held.size() + 1);
+			Node *memory = _allocator.allocate(count + 1);
+			Slab_ *slab = new (memory) Slab_(count);
+			Held_ held = { memory + 1, memory + 1 + count, slab, 0 };
+			hold(held);
+			_cursor = memory + 1;
+			_limit = _cursor + count;
+			_available += count;
+			if (_next_slab < _max_slab)
+				_next_slab *= 2;
+		}
+	};
+}
+
+#endif
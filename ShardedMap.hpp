@@ -0,0 +1,351 @@
+#pragma once
+#ifndef SHARDED_MAP_HPP
+#define SHARDED_MAP_HPP
+
+# include <cstddef>
+# include <functional>
+# include <memory>
+# include <mutex>
+# include <utility>
+# include "Iterator.hpp"
+# include "Map.hpp"
+# include "Parallel.hpp"
+# include "Utility.hpp"
+# include "Vector.hpp"
+
+namespace ft {
+	/*
+	** Ordered map for write-heavy use from many threads: keys are spread by
+	** hash over N ft::Map shards, each behind its own mutex, so writers only
+	** contend when they land on the same shard. Single-key operations lock
+	** one shard and hand back bools or copies rather than iterators, which
+	** would not survive other writers. Ordered iteration merges the shards
+	** k-way; it and the iterator-returning lookups are not locked and need
+	** the map to be left alone by writers meanwhile. for_each_shard runs a
+	** callback over the shards on several threads, each under its lock.
+	*/
+	template <class Key, class T, std::size_t N, class Compare = std::less<Key>, class Hash = std::hash<Key>,
+			class A = std::allocator<ft::pair<const Key, T> > >
+	class ShardedMap {
+	public:
+		typedef ft::Map<Key, T, Compare, A>											map_type;
+		typedef Key																	key_type;
+		typedef T																	mapped_type;
+		typedef typename map_type::value_type										value_type;
+		typedef std::size_t															size_type;
+		typedef std::ptrdiff_t														difference_type;
+		typedef Compare																key_compare;
+		typedef Hash																hasher;
+		typedef A																	allocator_type;
+		typedef value_type&															reference;
+		typedef const value_type&													const_reference;
+		typedef ft::MergeIterator<typename map_type::iterator, Compare, N>			iterator;
+		typedef ft::MergeIterator<typename map_type::const_iterator, Compare, N>	const_iterator;
+
+		static const size_type	shard_count = N;
+
+	private:
+		/* Padded by a cache line, so that the lock and tree header of one
+		** shard never share a line with those of its neighbour. */
+		struct Shard_ {
+			mutable std::mutex	lock;
+			map_type			map;
+			char				pad[64];
+		};
+
+		typedef std::lock_guard<std::mutex>	Lock_;
+
+		Compare			_comp;
+		Hash			_hash;
+		allocator_type	_allocator;
+		Shard_			_shards[N];
+
+	public:
+		/**************************** Constructors ****************************/
+		explicit ShardedMap(const Compare& comp = Compare(), const Hash& hash = Hash(), const A& alloc = A())
+			: _comp(comp), _hash(hash), _allocator(alloc) {
+			initShards();
+		}
+
+		template <class InputIt>
+		ShardedMap(InputIt first, InputIt last, const Compare& comp = Compare(), const Hash& hash = Hash(),
+				const A& alloc = A()) : _comp(comp), _hash(hash), _allocator(alloc) {
+			initShards();
+			insert(first, last);
+		}
+
+		ShardedMap(const ShardedMap& other)
+			: _comp(other._comp), _hash(other._hash), _allocator(other._allocator) {
+			initShards();
+			for (size_type i = 0; i < N; ++i) {
+				Lock_ lock(other._shards[i].lock);
+				_shards[i].map = other._shards[i].map;
+			}
+		}
+
+		/* Shard by shard: the copy is consistent per shard, not as a whole.
+		** The hash comes along with the shards it placed keys in, so this map
+		** must be left alone by other threads meanwhile. */
+		ShardedMap& operator=(const ShardedMap& other) {
+			if (this == &other)
+				return *this;
+			_comp = other._comp;
+			_hash = other._hash;
+			_allocator = other._allocator;
+			for (size_type i = 0; i < N; ++i) {
+				std::lock(_shards[i].lock, other._shards[i].lock);
+				Lock_ mine(_shards[i].lock, std::adopt_lock);
+				Lock_ theirs(other._shards[i].lock, std::adopt_lock);
+				_shards[i].map = other._shards[i].map;
+			}
+			return *this;
+		}
+
+		~ShardedMap() {}
+
+		/*************************** Members Methods **************************/
+		allocator_type		get_allocator() const	{ return _allocator; }
+		key_compare			key_comp() const		{ return _comp; }
+		hasher				hash_function() const	{ return _hash; }
+		bool				empty() const			{ return size() == 0; }
+		size_type			max_size() const		{ return _shards[0].map.max_size(); }
+
+		size_type size() const {
+			size_type n = 0;
+
+			for (size_type i = 0; i < N; ++i) {
+				Lock_ lock(_shards[i].lock);
+				n += _shards[i].map.size();
+			}
+			return n;
+		}
+
+		void clear() {
+			for (size_type i = 0; i < N; ++i) {
+				Lock_ lock(_shards[i].lock);
+				_shards[i].map.clear();
+			}
+		}
+
+		/* The shard a key lives in, and direct access to it; the caller
+		** locks nothing and so has to keep writers away. */
+		size_type			shard_of( const Key& key ) const	{ return shardIndex(key); }
+		map_type&			shard( size_type i )				{ return _shards[i].map; }
+		const map_type&		shard( size_type i ) const			{ return _shards[i].map; }
+
+		iterator			begin()					{ return mergeBounds<iterator>(BeginOf_()); }
+		const_iterator		begin() const			{ return mergeBounds<const_iterator>(BeginOf_()); }
+		iterator			end()					{ return iterator(); }
+		const_iterator		end() const				{ return const_iterator(); }
+
+		iterator			lower_bound( const Key& key )			{ return mergeBounds<iterator>(LowerOf_(key)); }
+		const_iterator		lower_bound( const Key& key ) const		{ return mergeBounds<const_iterator>(LowerOf_(key)); }
+		iterator			upper_bound( const Key& key )			{ return mergeBounds<iterator>(UpperOf_(key)); }
+		const_iterator		upper_bound( const Key& key ) const		{ return mergeBounds<const_iterator>(UpperOf_(key)); }
+
+		/* Each returns whether the key was new. */
+		bool insert( const value_type& value ) {
+			Shard_& s = shardFor(value.first);
+			Lock_ lock(s.lock);
+
+			return s.map.insert(value).second;
+		}
+
+		bool insert( value_type&& value ) {
+			Shard_& s = shardFor(value.first);
+			Lock_ lock(s.lock);
+
+			return s.map.insert(std::move(value)).second;
+		}
+
+		template <class InputIt>
+		void insert( InputIt first, InputIt last ) {
+			for ( ; first != last; ++first)
+				insert(*first);
+		}
+
+		template <class... Args>
+		bool emplace( Args&&... args ) { return insert(value_type(std::forward<Args>(args)...)); }
+
+		template <class... Args>
+		bool try_emplace( const Key& key, Args&&... args ) {
+			Shard_& s = shardFor(key);
+			Lock_ lock(s.lock);
+
+			return s.map.try_emplace(key, std::forward<Args>(args)...).second;
+		}
+
+		template <class M>
+		bool insert_or_assign( const Key& key, M&& obj ) {
+			Shard_& s = shardFor(key);
+			Lock_ lock(s.lock);
+
+			return s.map.insert_or_assign(key, std::forward<M>(obj)).second;
+		}
+
+		/*
+		** Parallel bulk load: one pass hashes the input into per-shard
+		** buckets, then up to threads threads (all cores by default) fill
+		** the shards, each locked once for its whole bucket. The input is
+		** walked twice, so it has to be a forward range.
+		*/
+		template <class ForwardIt>
+		void insert_parallel( ForwardIt first, ForwardIt last, unsigned threads = 0 ) {
+			ft::Vector<ForwardIt> buckets[N];
+
+			for ( ; first != last; ++first)
+				buckets[shardIndex(first->first)].push_back(first);
+			ft::parallel_for(N, threads, FillShard_<ForwardIt>(_shards, buckets));
+		}
+
+		size_type erase( const Key& key ) {
+			Shard_& s = shardFor(key);
+			Lock_ lock(s.lock);
+
+			return s.map.erase(key);
+		}
+
+		size_type count( const Key& key ) const {
+			const Shard_& s = shardFor(key);
+			Lock_ lock(s.lock);
+
+			return s.map.count(key);
+		}
+
+		/* Copies the mapped value out under the lock. */
+		bool get( const Key& key, T& value ) const {
+			const Shard_& s = shardFor(key);
+			Lock_ lock(s.lock);
+			typename map_type::const_iterator pos = s.map.find(key);
+
+			if (pos == s.map.end())
+				return false;
+			value = pos->second;
+			return true;
+		}
+
+		/* Calls f on the entry for key, if any, with its shard locked. */
+		template <class F>
+		bool visit( const Key& key, F f ) {
+			Shard_& s = shardFor(key);
+			Lock_ lock(s.lock);
+			typename map_type::iterator pos = s.map.find(key);
+
+			if (pos == s.map.end())
+				return false;
+			f(*pos);
+			return true;
+		}
+
+		template <class F>
+		bool visit( const Key& key, F f ) const {
+			const Shard_& s = shardFor(key);
+			Lock_ lock(s.lock);
+			typename map_type::const_iterator pos = s.map.find(key);
+
+			if (pos == s.map.end())
+				return false;
+			f(*pos);
+			return true;
+		}
+
+		/*
+		** Calls f(map, index) once per shard, on up to threads threads (all
+		** cores by default), with that shard locked. Shards are handed out
+		** one at a time, so uneven ones balance out. The first exception
+		** thrown by f is rethrown here once every thread has stopped.
+		*/
+		template <class F>
+		void for_each_shard( F f, unsigned threads = 0 )		{ ft::parallel_for(N, threads, VisitShard_<F, Shard_>(_shards, f)); }
+
+		template <class F>
+		void for_each_shard( F f, unsigned threads = 0 ) const	{ ft::parallel_for(N, threads, VisitShard_<F, const Shard_>(_shards, f)); }
+
+	private:
+		struct BeginOf_ {
+			template <class M> typename M::iterator			operator()(M& m) const			{ return m.begin(); }
+			template <class M> typename M::const_iterator	operator()(const M& m) const	{ return m.begin(); }
+		};
+
+		struct LowerOf_ {
+			const Key& key;
+			LowerOf_(const Key& k): key(k) {}
+			template <class M> typename M::iterator			operator()(M& m) const			{ return m.lower_bound(key); }
+			template <class M> typename M::const_iterator	operator()(const M& m) const	{ return m.lower_bound(key); }
+		};
+
+		struct UpperOf_ {
+			const Key& key;
+			UpperOf_(const Key& k): key(k) {}
+			template <class M> typename M::iterator			operator()(M& m) const			{ return m.upper_bound(key); }
+			template <class M> typename M::const_iterator	operator()(const M& m) const	{ return m.upper_bound(key); }
+		};
+
+		template <class ForwardIt>
+		struct FillShard_ {
+			Shard_					*shards;
+			ft::Vector<ForwardIt>	*buckets;
+			FillShard_(Shard_ *s, ft::Vector<ForwardIt> *b): shards(s), buckets(b) {}
+
+			void operator()(size_type i) const {
+				Lock_ lock(shards[i].lock);
+
+				for (size_type j = 0; j < buckets[i].size(); ++j)
+					shards[i].map.insert(*buckets[i][j]);
+			}
+		};
+
+		template <class F, class S>
+		struct VisitShard_ {
+			S	*shards;
+			F	&f;
+			VisitShard_(S *s, F& fn): shards(s), f(fn) {}
+
+			void operator()(size_type i) const {
+				Lock_ lock(shards[i].lock);
+
+				f(shards[i].map, i);
+			}
+		};
+
+		/* Fibonacci hashing, as in ft::HashTable, so that weak hashes such
+		** as the identity on integers still spread over the shards. */
+		size_type shardIndex(const Key& key) const {
+			return static_cast<size_type>(((static_cast<unsigned long long>(_hash(key)) * 0x9E3779B97F4A7C15ULL) >> 32) % N);
+		}
+
+		Shard_&			shardFor(const Key& key)		{ return _shards[shardIndex(key)]; }
+		const Shard_&	shardFor(const Key& key) const	{ return _shards[shardIndex(key)]; }
+
+		/* Shards hold mutexes, which cannot move, so they are default built
+		** in place and handed the comparator and allocator afterwards. */
+		void initShards() {
+			for (size_type i = 0; i < N; ++i)
+				_shards[i].map = map_type(_comp, _allocator);
+		}
+
+		template <class It, class Bound>
+		It mergeBounds(Bound bound) {
+			typename map_type::iterator	first[N], last[N];
+
+			for (size_type i = 0; i < N; ++i) {
+				first[i] = bound(_shards[i].map);
+				last[i] = _shards[i].map.end();
+			}
+			return It(first, last, _comp);
+		}
+
+		template <class It, class Bound>
+		It mergeBounds(Bound bound) const {
+			typename map_type::const_iterator	first[N], last[N];
+
+			for (size_type i = 0; i < N; ++i) {
+				first[i] = bound(_shards[i].map);
+				last[i] = _shards[i].map.end();
+			}
+			return It(first, last, _comp);
+		}
+	};
+}
+
+#endif
@@ -2,6 +2,7 @@
 #ifndef STACK_HPP
 #define STACK_HPP
 
+# include <utility>
 # include "Vector.hpp"
 
 namespace ft {
@@ -17,7 +18,9 @@ namespace ft {
 
 		/**************************** Constructors ****************************/
 		explicit Stack(const Container& container = Container()): _container(container) {}
+		explicit Stack(Container&& container): _container(std::move(container)) {}
 		Stack(const Stack& other): _container(other._container) {}
+		Stack(Stack&& other): _container(std::move(other._container)) {}
 		~Stack() {};
 		Stack& operator=(const Stack& other) {
 			if (this == &other)
@@ -25,6 +28,12 @@ namespace ft {
 			_container = other._container;
 			return *this;
 		}
+		Stack& operator=(Stack&& other) {
+			if (this == &other)
+				return *this;
+			_container = std::move(other._container);
+			return *this;
+		}
 
 		/****************************** Capacity ******************************/
 		bool empty() const { return _container.empty(); }
@@ -36,6 +45,9 @@ namespace ft {
 
 		/****************************** Modifiers *****************************/
 		void push(const value_type& value) { return _container.push_back(value); }
+		void push(value_type&& value) { return _container.push_back(std::move(value)); }
+		template <class... Args>
+		void emplace(Args&&... args) { _container.emplace_back(std::forward<Args>(args)...); }
 		void pop() { return _container.pop_back(); }
 
 		/************************ Operator overloading ************************/
@@ -0,0 +1,172 @@
+#pragma once
+#ifndef UNORDERED_SET_HPP
+#define UNORDERED_SET_HPP
+
+# include <functional>
+# include <limits>
+# include "HashTable.hpp"
+# include "Iterator.hpp"
+# include "Utility.hpp"
+# include "Vector.hpp"
+
+namespace ft {
+	/*
+	** Hash set on the same open-addressing ft::HashTable as ft::UnorderedMap.
+	** Insert and erase invalidate iterators.
+	*/
+	template <class Key, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>, class A = std::allocator<Key> >
+	class UnorderedSet {
+	public:
+		typedef Key																	key_type;
+		typedef Key																	value_type;
+		typedef std::size_t															size_type;
+		typedef std::ptrdiff_t														difference_type;
+		typedef Hash																hasher;
+		typedef KeyEqual															key_equal;
+		typedef A																	allocator_type;
+		typedef const value_type&													reference;
+		typedef const value_type&													const_reference;
+		typedef ft::HashTable<Key, Key, ft::Identity_<Key>, Hash, KeyEqual, A>		table_type;
+		typedef typename table_type::const_iterator									iterator;
+		typedef typename table_type::const_iterator									const_iterator;
+
+	private:
+		allocator_type		_allocator;
+		table_type			_table;
+
+	public:
+		/**************************** Constructors ****************************/
+		UnorderedSet() {}
+
+		explicit UnorderedSet(size_type bucket_count, const Hash& hash = Hash(),
+				const KeyEqual& eq = KeyEqual(), const A& alloc = A()) : _allocator(alloc), _table(hash, eq, alloc) {
+			_table.rehash(bucket_count);
+		}
+
+		template <class InputIt>
+		UnorderedSet(InputIt first, InputIt last, size_type bucket_count = 0, const Hash& hash = Hash(),
+				const KeyEqual& eq = KeyEqual(), const A& alloc = A()) : _allocator(alloc), _table(hash, eq, alloc) {
+			if (bucket_count)
+				_table.rehash(bucket_count);
+			insert(first, last);
+		}
+
+		UnorderedSet(const UnorderedSet& other) : _allocator(other._allocator), _table(other._table) {}
+
+		UnorderedSet& operator=(const UnorderedSet& other) {
+			if (this == &other)
+				return *this;
+			_allocator = other._allocator;
+			_table = other._table;
+			return *this;
+		}
+
+		~UnorderedSet() {}
+
+		/*************************** Members Methods **************************/
+		allocator_type		get_allocator() const	{ return _allocator; }
+		iterator			begin() const			{ return _table.begin(); }
+		iterator			end() const				{ return _table.end(); }
+		bool				empty() const			{ return size() == 0; }
+		size_type			size() const			{ return _table.size(); }
+		size_type			max_size() const		{ return std::numeric_limits<difference_type>::max() / (sizeof(value_type) + 1); }
+
+		void clear()								{ _table.clear(); }
+
+		ft::pair<iterator, bool> insert( const value_type& value ) {
+			ft::pair<typename table_type::iterator, bool> ret = _table.insertUnique(value);
+			return ft::pair<iterator, bool>(ret.first, ret.second);
+		}
+
+		iterator insert( const_iterator, const value_type& value ) {
+			return _table.insertUnique(value).first;
+		}
+
+		template <class InputIt>
+		void insert( InputIt first, InputIt last ) {
+			for ( ; first != last; ++first)
+				_table.insertUnique(*first);
+		}
+
+		void erase( iterator pos )					{ _table.erase(unconst(pos)); }
+
+		/* Erasing shifts later slots back, so the keys are gathered first. */
+		void erase( iterator first, iterator last ) {
+			ft::Vector<Key> keys;
+
+			if (first == begin() && last == end())
+				return clear();
+			for ( ; first != last; ++first)
+				keys.push_back(*first);
+			for (size_type i = 0; i < keys.size(); ++i)
+				erase(keys[i]);
+		}
+
+		size_type erase( const key_type& key ) {
+			typename table_type::iterator pos = _table.find(key);
+
+			if (pos == _table.end()) return 0;
+			_table.erase(pos);
+			return 1;
+		}
+
+		void swap( UnorderedSet& other ) {
+			std::swap(_allocator, other._allocator);
+			_table.swap(other._table);
+		}
+
+		size_type		count( const Key& key ) const	{ return find(key) == end() ? 0 : 1; }
+		iterator		find( const Key& key ) const	{ return _table.find(key); }
+
+		ft::pair<iterator,iterator> equal_range( const Key& key ) const {
+			iterator pos = find(key);
+			return ft::pair<iterator, iterator>(pos, pos == end() ? pos : ++iterator(pos));
+		}
+
+		/* Heterogeneous lookup when both Hash and KeyEqual are transparent. */
+		template <class K, class H = Hash, class E = KeyEqual>
+		typename ft::enable_if<ft::is_transparent<H>::value && ft::is_transparent<E>::value, iterator>::type
+		find( const K& key ) const				{ return _table.find(key); }
+
+		template <class K, class H = Hash, class E = KeyEqual>
+		typename ft::enable_if<ft::is_transparent<H>::value && ft::is_transparent<E>::value, size_type>::type
+		count( const K& key ) const				{ return find(key) == end() ? 0 : 1; }
+
+		template <class K, class H = Hash, class E = KeyEqual>
+		typename ft::enable_if<ft::is_transparent<H>::value && ft::is_transparent<E>::value
+			&& !std::is_convertible<K, iterator>::value, size_type>::type
+		erase( const K& key ) {
+			typename table_type::iterator pos = _table.find(key);
+
+			if (pos == _table.end()) return 0;
+			_table.erase(pos);
+			return 1;
+		}
+
+		size_type	bucket_count() const			{ return _table.capacity(); }
+		float		load_factor() const				{ return bucket_count() ? float(size()) / bucket_count() : 0.0f; }
+		float		max_load_factor() const			{ return _table.maxLoad(); }
+		void		max_load_factor( float ml )		{ _table.maxLoad(ml); }
+		void		rehash( size_type count )		{ _table.rehash(count); }
+		void		reserve( size_type count )		{ _table.reserve(count); }
+		hasher		hash_function() const			{ return _table.hash(); }
+		key_equal	key_eq() const					{ return _table.eq(); }
+
+		friend bool operator== (const UnorderedSet &lhs, const UnorderedSet &rhs) {
+			if (lhs.size() != rhs.size())
+				return false;
+			for (iterator it = lhs.begin(); it != lhs.end(); ++it)
+				if (rhs.find(*it) == rhs.end())
+					return false;
+			return true;
+		}
+		friend bool operator!= (const UnorderedSet &lhs, const UnorderedSet &rhs) { return !(lhs == rhs); }
+
+	private:
+		typename table_type::iterator unconst(iterator pos) const {
+			return typename table_type::iterator(const_cast<Key*>(pos.slot()), pos.dist());
+		}
+	};
+}
+
+#endif
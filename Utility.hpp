@@ -2,10 +2,14 @@
 #ifndef UTILITY_HPP
 #define UTILITY_HPP
 
+# include <cstddef>
+# include <type_traits>
+# include <utility>
+
 namespace ft {
 	template <class T, class A>
 	class Vector;
-	template <class Key, class T, class Compare, class A>
+	template <class Key, class T, class Compare, class A, class Augment>
 	class Map;
 
 	template <class T, bool v>
@@ -32,9 +36,57 @@ namespace ft {
 	template <> struct is_integral<long long> : public integral_constant<bool, true> {};
 	template <> struct is_integral<unsigned long long> : public integral_constant<bool, true> {};
 
+	/* Tag promising that a range is sorted by the comparator, without repeats. */
+	struct sorted_unique_t { sorted_unique_t() {} };
+	const sorted_unique_t sorted_unique;
+
 	template <bool B, class T = void> struct enable_if {};
 	template <class T> struct enable_if<true, T> { typedef T type; };
 
+	template <class T> struct void_type { typedef void type; };
+
+	/* Detects Compare::is_transparent, which enables heterogeneous lookup. */
+	template <class Compare, class = void>
+	struct is_transparent : public integral_constant<bool, false> {};
+	template <class Compare>
+	struct is_transparent<Compare, typename void_type<typename Compare::is_transparent>::type>
+		: public integral_constant<bool, true> {};
+
+	/* Detects tree nodes that keep their subtree size (ft::OrderStatistics). */
+	template <class Node, class = void>
+	struct has_subtree_count : public integral_constant<bool, false> {};
+	template <class Node>
+	struct has_subtree_count<Node, typename void_type<decltype(((Node*)0)->count)>::type>
+		: public integral_constant<bool, true> {};
+
+	/* Detects tree nodes threaded in key order (ft::Threaded). */
+	template <class Node, class = void>
+	struct has_thread_links : public integral_constant<bool, false> {};
+	template <class Node>
+	struct has_thread_links<Node, typename void_type<decltype(((Node*)0)->succ)>::type>
+		: public integral_constant<bool, true> {};
+
+	/* Key extractors for containers that store whole values. */
+	template <class Pair>
+	struct SelectFirst_ {
+		const typename Pair::first_type& operator()(const Pair& p) const { return p.first; }
+	};
+
+	template <class T>
+	struct Identity_ {
+		const T& operator()(const T& x) const { return x; }
+	};
+
+	/* Key conflict policies for Map::merge and Map::set_union, called with the
+	** mapped value kept in the map and the one that collided with it. */
+	struct KeepExisting {
+		template <class T> void operator()(T&, const T&) const {}
+	};
+
+	struct TakeIncoming {
+		template <class T> void operator()(T& existing, const T& incoming) const { existing = incoming; }
+	};
+
 	template <class Iterator1, class Iterator2>
 	bool equal(Iterator1 left1, Iterator1 right1, Iterator2 left2) {
 		for ( ; left1 != right1; ++left1, ++left2)
@@ -60,6 +112,74 @@ namespace ft {
 		return left1 == right1 && left2 != right2;
 	}
 
+	/*
+	** Search policies for the flat containers. Both return the index of the
+	** first of n sorted keys that is not less than (lower) or greater than
+	** (upper) key. BranchlessSearch halves the range with a conditional move
+	** instead of a branch, which pays off on large, unpredictable probes.
+	*/
+	struct BinarySearch {
+		template <class Key, class K, class Compare>
+		static std::size_t lower(const Key *keys, std::size_t n, const K& key, const Compare& comp) {
+			std::size_t first = 0;
+
+			while (n) {
+				std::size_t half = n / 2;
+				if (comp(keys[first + half], key)) {
+					first += half + 1;
+					n -= half + 1;
+				} else {
+					n = half;
+				}
+			}
+			return first;
+		}
+
+		template <class Key, class K, class Compare>
+		static std::size_t upper(const Key *keys, std::size_t n, const K& key, const Compare& comp) {
+			std::size_t first = 0;
+
+			while (n) {
+				std::size_t half = n / 2;
+				if (!comp(key, keys[first + half])) {
+					first += half + 1;
+					n -= half + 1;
+				} else {
+					n = half;
+				}
+			}
+			return first;
+		}
+	};
+
+	struct BranchlessSearch {
+		template <class Key, class K, class Compare>
+		static std::size_t lower(const Key *keys, std::size_t n, const K& key, const Compare& comp) {
+			const Key *base = keys;
+
+			if (!n) return 0;
+			while (n > 1) {
+				std::size_t half = n / 2;
+				base = comp(base[half], key) ? base + half : base;
+				n -= half;
+			}
+			return (base - keys) + comp(*base, key);
+		}
+
+		template <class Key, class K, class Compare>
+		static std::size_t upper(const Key *keys, std::size_t n, const K& key, const Compare& comp) {
+			const Key *base = keys;
+
+			if (!n) return 0;
+			while (n > 1) {
+				std::size_t half = n / 2;
+				base = !comp(key, base[half]) ? base + half : base;
+				n -= half;
+			}
+			return (base - keys) + !comp(key, *base);
+		}
+	};
+
 	template <class T1, typename T2>
 	struct pair {
 		typedef T1 first_type;
@@ -68,16 +188,35 @@ namespace ft {
 		T2 second;
 		pair(): first(), second() {}
 		pair(T1 const& t1, T2 const& t2): first(t1), second(t2) {}
+		pair(const pair& p): first(p.first), second(p.second) {}
+		pair(pair&& p) noexcept(std::is_nothrow_move_constructible<T1>::value
+				&& std::is_nothrow_move_constructible<T2>::value): first(std::forward<T1>(p.first)), second(std::forward<T2>(p.second)) {}
+
+		/* Builds each member from whatever it can be constructed from,
+		** moving rvalues in. */
+		template <class U1, class U2, class = typename enable_if<std::is_constructible<T1, U1&&>::value
+				&& std::is_constructible<T2, U2&&>::value>::type>
+		pair(U1&& u1, U2&& u2): first(std::forward<U1>(u1)), second(std::forward<U2>(u2)) {}
 
 		template <class U1, class U2>
 		pair(const pair<U1, U2>& p): first(p.first), second(p.second) {}
 
+		template <class U1, class U2>
+		pair(pair<U1, U2>&& p): first(std::forward<U1>(p.first)), second(std::forward<U2>(p.second)) {}
+
 		pair& operator=(pair const& p) {
 			first = p.first;
 			second = p.second;
 			return *this;
 		}
 
+		pair& operator=(pair&& p) noexcept(std::is_nothrow_move_assignable<T1>::value
+				&& std::is_nothrow_move_assignable<T2>::value) {
+			first = std::forward<T1>(p.first);
+			second = std::forward<T2>(p.second);
+			return *this;
+		}
+
 		void swap(pair& p) {
 			std::swap(first,  p.first);
 			std::swap(second, p.second);
@@ -126,8 +265,8 @@ namespace std {
 		v1.swap(v2);
 	}
 
-	template <class Key, class T, class Compare, class A>
-	void swap(ft::Map<Key, T, Compare, A> &m1, ft::Map<Key, T, Compare, A> &m2 ) {
+	template <class Key, class T, class Compare, class A, class Augment>
+	void swap(ft::Map<Key, T, Compare, A, Augment> &m1, ft::Map<Key, T, Compare, A, Augment> &m2 ) {
 		m1.swap(m2);
 	}
 }
@@ -3,6 +3,8 @@
 #define VECTOR_HPP
 
 # include <memory>
+# include <limits>
+# include <utility>
 # include "Iterator.hpp"
 #include <stdexcept>
 
@@ -39,7 +41,7 @@ namespace ft {
 			_capacity = _size = count;
 			_buffer = _allocator.allocate(_capacity);
 			for (size_t i = 0; i < _size; ++i)
-				_buffer[i] = value;
+				_allocator.construct(_buffer + i, value);
 		}
 
 		template <class Iterator>
@@ -49,21 +51,40 @@ namespace ft {
 			this->assign(left, right);
 		}
 		
-		Vector(const Vector& other): _buffer(0), _capacity(other._capacity), _size(other._size), _allocator(other.getAllocator()) {
-			_buffer = _allocator.allocate(other._capacity);
+		/* Sized to fit, as std::vector copies; an empty one allocates nothing. */
+		Vector(const Vector& other): _buffer(0), _capacity(other._size), _size(other._size), _allocator(other.getAllocator()) {
+			if (_capacity)
+				_buffer = _allocator.allocate(_capacity);
 			for (size_t i = 0; i < _size; ++i)
-				_buffer[i] = other._buffer[i];
+				_allocator.construct(_buffer + i, other._buffer[i]);
 		}
 
-		Vector& operator=(const Vector& other) {
+		Vector(Vector&& other) noexcept: _buffer(other._buffer), _capacity(other._capacity), _size(other._size), _allocator(other._allocator) {
+			other._buffer = 0;
+			other._capacity = other._size = 0;
+		}
+
+		Vector& operator=(Vector&& other) noexcept {
 			if (this == &other) return *this;
 			this->clear();
 			_allocator.deallocate(_buffer, _capacity);
+			_buffer = other._buffer;
 			_capacity = other._capacity;
 			_size = other._size;
-			_buffer = _allocator.allocate(_capacity);
+			_allocator = other._allocator;
+			other._buffer = 0;
+			other._capacity = other._size = 0;
+			return *this;
+		}
+
+		Vector& operator=(const Vector& other) {
+			if (this == &other) return *this;
+			this->clear();
+			_allocator.deallocate(_buffer, _capacity);
+			_capacity = _size = other._size;
+			_buffer = _capacity ? _allocator.allocate(_capacity) : 0;
 			for (size_t i = 0; i < _size; ++i)
-				_buffer[i] = other._buffer[i];
+				_allocator.construct(_buffer + i, other._buffer[i]);
 			return *this;
 		}
 
@@ -78,7 +99,7 @@ namespace ft {
 			this->clear();
 			this->reserve(count);
 			for (size_t i = 0; i < count; ++i, _size++)
-				_buffer[i] = value;
+				_allocator.construct(_buffer + i, value);
 		}
 
 		template <class Iterator>
@@ -97,9 +118,12 @@ namespace ft {
 		void	reserve(size_type size) {
 			if (size > _capacity) {
 				T* tmp = _allocator.allocate(size);
-				for (size_t i = 0; i < _size; ++i)
-					tmp[i] = _buffer[i];
-				if (_buffer) _allocator.deallocate(_buffer, _capacity);
+				try {
+					relocate(tmp);
+				} catch (...) {
+					_allocator.deallocate(tmp, size);
+					throw;
+				}
 				_capacity = size;
 				_buffer = tmp;
 			}
@@ -172,33 +196,61 @@ namespace ft {
 
 		iterator	erase(iterator pos) {
 			int index = pos - begin();
-			for (size_t i = index; i < _size; ++i)
-				_buffer[i] = _buffer[i + 1];
-			_size--;
+			for (size_t i = index; i + 1 < _size; ++i)
+				_buffer[i] = std::move(_buffer[i + 1]);
+			_allocator.destroy(_buffer + --_size);
 			return pos;
 		}
 
 		iterator	erase(iterator left, iterator right) {
+			if (left == right) return left;
 			int start = left - begin();
 			int end = right - begin();
 			int offset = end - start;
 
+			for (size_t i = start; i + offset < _size; ++i)
+				_buffer[i] = std::move(_buffer[i + offset]);
+			for (size_t i = _size - offset; i < _size; ++i)
+				_allocator.destroy(_buffer + i);
 			_size -= offset;
-			for (size_t i = start; i < _size; ++i)
-				_buffer[i] = _buffer[i + offset];
 			return _buffer + start;
 		}
 
-		void	push_back(const_reference value) {
-			if (_size == _capacity)
-				(!_capacity) ? this->reserve(1) : this->reserve(_capacity * 2);
-			_buffer[_size] = value;
-			++_size;
+		void	push_back(const_reference value)	{ emplace_back(value); }
+		void	push_back(T&& value)				{ emplace_back(std::move(value)); }
+
+		/* Builds the element in place. On growth it is built in the new buffer
+		** before the old elements move over, so args may refer into *this. */
+		template <class... Args>
+		reference	emplace_back(Args&&... args) {
+			if (_size == _capacity) {
+				size_type size = _capacity ? _capacity * 2 : 1;
+				T* tmp = _allocator.allocate(size);
+
+				try {
+					_allocator.construct(tmp + _size, std::forward<Args>(args)...);
+				} catch (...) {
+					_allocator.deallocate(tmp, size);
+					throw;
+				}
+				try {
+					relocate(tmp);
+				} catch (...) {
+					_allocator.destroy(tmp + _size);
+					_allocator.deallocate(tmp, size);
+					throw;
+				}
+				_capacity = size;
+				_buffer = tmp;
+			} else {
+				_allocator.construct(_buffer + _size, std::forward<Args>(args)...);
+			}
+			return _buffer[_size++];
 		}
 
 		void	pop_back() {
-			_allocator.destroy(_buffer + _size);
 			_size--;
+			_allocator.destroy(_buffer + _size);
 		}
 
 		void	resize(size_type count, T value = T()) {
@@ -309,6 +361,26 @@ namespace ft {
 		size_type				max_size() const 					{ return (std::min((size_type) std::numeric_limits<difference_type>::max(),
 																		std::numeric_limits<size_type>::max() / sizeof(value_type))); }
 	private:
+		/* Moves the elements into tmp and frees the old buffer; elements whose
+		** move may throw are copied, so a failed growth leaves them intact.
+		** On a throw the elements already built in tmp are destroyed and tmp
+		** is left for the caller to free. */
+		void	relocate(T* tmp) {
+			size_t i = 0;
+
+			try {
+				for ( ; i < _size; ++i)
+					_allocator.construct(tmp + i, std::move_if_noexcept(_buffer[i]));
+			} catch (...) {
+				while (i--)
+					_allocator.destroy(tmp + i);
+				throw;
+			}
+			for (i = 0; i < _size; ++i)
+				_allocator.destroy(_buffer + i);
+			if (_buffer) _allocator.deallocate(_buffer, _capacity);
+		}
+
 		template<class Iterator>
 		typename ft::enable_if<!ft::is_integral<Iterator>::value, bool>::type
 		validate_iterator_values(Iterator first, Iterator last, size_t range) {
@@ -0,0 +1,63 @@
+/*
+** ft::BTreeMap<int, int> against ft::Map<int, int>: nanoseconds per insert,
+** per find and per element of an in-order scan, from 1K to 100M entries.
+** g++ -std=c++14 -O2 -I.. btree_map.cpp -o btree_map && ./btree_map [max entries]
+*/
+#include "BTreeMap.hpp"
+#include "Map.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+/* Keys are scattered so both trees are built by real inserts, not in order. */
+static int key(long i) { return static_cast<int>(static_cast<unsigned>(i) * 2654435761u); }
+
+static double since(std::chrono::steady_clock::time_point start, long ops) {
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / ops;
+}
+
+struct Timings { double insert, find, scan; long check; };
+
+template <class Map>
+static Timings run(long n) {
+	Timings t;
+	Map map;
+	long lookups = n < 10000000 ? n : 10000000;
+	long sum = 0;
+	unsigned s = 1;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (long i = 0; i < n; ++i)
+		map.insert(ft::pair<const int, int>(key(i), static_cast<int>(i)));
+	t.insert = since(start, n);
+
+	start = std::chrono::steady_clock::now();
+	for (long i = 0; i < lookups; ++i) {
+		s = s * 1103515245u + 12345u;
+		sum += map.find(key(s % n))->second;
+	}
+	t.find = since(start, lookups);
+
+	start = std::chrono::steady_clock::now();
+	for (typename Map::const_iterator it = map.begin(); it != map.end(); ++it)
+		sum += it->second;
+	t.scan = since(start, n);
+	t.check = sum;
+	return t;
+}
+
+int main(int argc, char **argv) {
+	long max = argc > 1 ? std::atol(argv[1]) : 100000000;
+	long check = 0;
+
+	std::printf("%10s %18s %18s %18s\n", "entries", "insert ns B/RB", "find ns B/RB", "scan ns B/RB");
+	for (long n = 1000; n <= max; n *= 10) {
+		Timings b = run<ft::BTreeMap<int, int> >(n);
+		Timings rb = run<ft::Map<int, int> >(n);
+		check += b.check - rb.check;
+		std::printf("%10ld %8.1f /%8.1f %8.1f /%8.1f %8.2f /%8.2f\n", n,
+			b.insert, rb.insert, b.find, rb.find, b.scan, rb.scan);
+	}
+	return check != 0;
+}
@@ -0,0 +1,96 @@
+/*
+** ft::ConcurrentMap scaling against an ft::Map behind a std::mutex: 1 to
+** 64 threads on a shared map of 1M keys, 90% lookups and 10% inserts or
+** erases.
+** g++ -std=c++11 -O2 -pthread -I.. concurrent_map.cpp -o concurrent_map && ./concurrent_map [ops per thread]
+*/
+#include "ConcurrentMap.hpp"
+#include "Map.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const int	keys = 1000000;
+
+class LockedMap {
+	ft::Map<int, int>	_map;
+	std::mutex			_mutex;
+
+public:
+	void insert(const ft::pair<const int, int>& value) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_map.insert(value);
+	}
+
+	std::size_t erase(int key) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _map.erase(key);
+	}
+
+	std::size_t count(int key) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _map.count(key);
+	}
+};
+
+template <class Map>
+struct Worker {
+	Map			*map;
+	long		ops;
+	unsigned	seed;
+	long		*hits;
+
+	void operator()() const {
+		unsigned s = seed;
+		long found = 0;
+
+		for (long i = 0; i < ops; ++i) {
+			s = s * 1103515245u + 12345u;
+			int key = (s >> 8) % (2 * keys);
+			if (i % 10)
+				found += map->count(key);
+			else if (s & 0x100000)
+				map->insert(ft::pair<const int, int>(key | 1, i));
+			else
+				map->erase(key | 1);
+		}
+		*hits = found;
+	}
+};
+
+/* Millions of operations per second over all threads. */
+template <class Map>
+static double run(unsigned threads, long ops) {
+	Map map;
+	std::vector<std::thread> pool;
+	std::vector<long> hits(threads);
+
+	for (int i = 0; i < keys; ++i)
+		map.insert(ft::pair<const int, int>(2 * i, i));
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned t = 0; t < threads; ++t) {
+		Worker<Map> work = { &map, ops, t + 1, &hits[t] };
+		pool.push_back(std::thread(work));
+	}
+	for (unsigned t = 0; t < threads; ++t)
+		pool[t].join();
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return ops * threads / elapsed.count() / 1e6;
+}
+
+int main(int argc, char **argv) {
+	long ops = argc > 1 ? std::atol(argv[1]) : 1000000;
+
+	std::printf("%8s %18s %16s\n", "threads", "ConcurrentMap Mop/s", "mutex Mop/s");
+	for (unsigned threads = 1; threads <= 64; threads *= 2) {
+		double concurrent = run<ft::ConcurrentMap<int, int> >(threads, ops);
+		double locked = run<LockedMap>(threads, ops);
+		std::printf("%8u %18.2f %16.2f\n", threads, concurrent, locked);
+	}
+	return 0;
+}
@@ -0,0 +1,76 @@
+/*
+** ft::ConcurrentStack against an ft::Stack behind a std::mutex, 1 to 64
+** threads each doing push/pop pairs.
+** g++ -std=c++11 -O2 -pthread -I.. concurrent_stack.cpp -o concurrent_stack && ./concurrent_stack [pairs per thread]
+*/
+#include "ConcurrentStack.hpp"
+#include "Stack.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class LockedStack {
+	ft::Stack<long>	_stack;
+	std::mutex		_mutex;
+
+public:
+	void push(long value) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stack.push(value);
+	}
+
+	bool try_pop(long& value) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_stack.empty()) return false;
+		value = _stack.top();
+		_stack.pop();
+		return true;
+	}
+};
+
+template <class Stack>
+struct Worker {
+	Stack	*stack;
+	long	pairs;
+
+	void operator()() const {
+		long value;
+
+		for (long i = 0; i < pairs; ++i) {
+			stack->push(i);
+			stack->try_pop(value);
+		}
+	}
+};
+
+/* Millions of operations per second, a push or a pop counting as one. */
+template <class Stack>
+static double run(unsigned threads, long pairs) {
+	Stack stack;
+	std::vector<std::thread> pool;
+	Worker<Stack> work = { &stack, pairs };
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (unsigned t = 0; t < threads; ++t)
+		pool.push_back(std::thread(work));
+	for (unsigned t = 0; t < threads; ++t)
+		pool[t].join();
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return 2.0 * pairs * threads / elapsed.count() / 1e6;
+}
+
+int main(int argc, char **argv) {
+	long pairs = argc > 1 ? std::atol(argv[1]) : 1000000;
+
+	std::printf("%8s %16s %16s\n", "threads", "lock-free Mop/s", "mutex Mop/s");
+	for (unsigned threads = 1; threads <= 64; threads *= 2) {
+		double lockFree = run<ft::ConcurrentStack<long> >(threads, pairs);
+		double locked = run<LockedStack>(threads, pairs);
+		std::printf("%8u %16.2f %16.2f\n", threads, lockFree, locked);
+	}
+	return 0;
+}
@@ -0,0 +1,56 @@
+/*
+** Resident memory of an ft::Map<int, int> holding 10M entries, against
+** std::map. Linux only: sizes come from /proc/self/status.
+** g++ -std=c++11 -O2 -I.. map_memory.cpp -o map_memory && ./map_memory [entries]
+*/
+#include "Map.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+/* VmRSS in kB. */
+static long residentKb() {
+	std::FILE *status = std::fopen("/proc/self/status", "r");
+	char line[256];
+	long kb = 0;
+
+	if (!status) return 0;
+	while (std::fgets(line, sizeof(line), status))
+		if (!std::strncmp(line, "VmRSS:", 6))
+			kb = std::atol(line + 6);
+	std::fclose(status);
+	return kb;
+}
+
+/* Keys are scattered so the tree is built by real inserts, not in order. */
+static int key(int i) { return static_cast<int>(static_cast<unsigned>(i) * 2654435761u); }
+
+static void report(const char *name, long before, long after, int n) {
+	std::printf("%-10s %10.1f MB %10.1f bytes/entry\n", name,
+		(after - before) / 1024.0, (after - before) * 1024.0 / n);
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 10000000;
+	long before, after;
+
+	std::printf("%d entries, sizeof(Node_) = %zu\n", n, sizeof(Node_<ft::pair<const int, int> >));
+	{
+		before = residentKb();
+		ft::Map<int, int> m;
+		for (int i = 0; i < n; ++i)
+			m.insert(ft::pair<const int, int>(key(i), i));
+		after = residentKb();
+		report("ft::Map", before, after, n);
+	}
+	{
+		before = residentKb();
+		std::map<int, int> m;
+		for (int i = 0; i < n; ++i)
+			m.insert(std::pair<const int, int>(key(i), i));
+		after = residentKb();
+		report("std::map", before, after, n);
+	}
+	return 0;
+}
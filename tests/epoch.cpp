@@ -0,0 +1,64 @@
+/*
+** EpochDomain: what exited threads retired is still freed, and a guard
+** copied to another thread pins that thread.
+** g++ -std=c++11 -I.. -pthread -fsanitize=thread epoch.cpp -o epoch && ./epoch
+*/
+#include "Epoch.hpp"
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+static std::atomic<int>	freed(0);
+static int				items[4096];
+
+static void release(void *, void *ptr) {
+	*static_cast<int*>(ptr) = 1;
+	freed.fetch_add(1);
+}
+
+/* Retires enough from the calling thread to move the epoch on a few times. */
+static void churn(ft::EpochDomain& domain, int first, int count) {
+	for (int i = first; i < first + count; ++i) {
+		ft::EpochDomain::Guard g(domain);
+		domain.retire(&items[i]);
+	}
+}
+
+static void exitedThreadsAreDrained() {
+	ft::EpochDomain domain(release, 0);
+
+	for (int t = 0; t < 16; ++t) {
+		std::thread worker(churn, std::ref(domain), t * 10, 10);
+		worker.join();
+	}
+	churn(domain, 1000, 512);
+	for (int i = 0; i < 160; ++i)
+		assert(items[i] == 1);
+}
+
+static void copiedGuardPinsItsThread() {
+	ft::EpochDomain domain(release, 0);
+	std::atomic<int> step(0);
+	ft::EpochDomain::Guard *g = new ft::EpochDomain::Guard(domain);
+
+	std::thread reader([&]() {
+		ft::EpochDomain::Guard copy(*g);
+		step.store(1);
+		while (step.load() != 2) std::this_thread::yield();
+	});
+	while (step.load() != 1) std::this_thread::yield();
+	delete g;
+	domain.retire(&items[2000]);
+	churn(domain, 2001, 512);
+	assert(items[2000] == 0);
+	step.store(2);
+	reader.join();
+	churn(domain, 2600, 512);
+	assert(items[2000] == 1);
+}
+
+int main() {
+	exitedThreadsAreDrained();
+	copiedGuardPinsItsThread();
+	return 0;
+}
@@ -0,0 +1,71 @@
+/*
+** Reverse iteration over FlatMap and FlatSet, empty ones included.
+** g++ -std=c++14 -I.. -fsanitize=address,undefined flat_reverse.cpp -o flat_reverse && ./flat_reverse
+*/
+#include "FlatMap.hpp"
+#include "FlatSet.hpp"
+#include <cassert>
+#include <string>
+
+static void emptyContainers() {
+	ft::FlatMap<int, std::string> m;
+	const ft::FlatMap<int, std::string>& cm = m;
+	ft::FlatSet<int> s;
+
+	assert(m.rbegin() == m.rend() && cm.rbegin() == cm.rend());
+	assert(s.rbegin() == s.rend());
+	for (ft::FlatMap<int, std::string>::reverse_iterator it = m.rbegin(); it != m.rend(); ++it)
+		assert(false);
+}
+
+static void mapBackwards() {
+	ft::FlatMap<int, std::string> m;
+	for (int i = 0; i < 10; ++i)
+		m[i] = std::string(i + 1, 'x');
+
+	int expect = 9;
+	for (ft::FlatMap<int, std::string>::reverse_iterator it = m.rbegin(); it != m.rend(); ++it, --expect) {
+		assert(it->first == expect && (*it).first == expect);
+		it->second += "y";
+	}
+	assert(expect == -1 && m[3] == "xxxxy");
+
+	ft::FlatMap<int, std::string>::const_reverse_iterator cit = m.rbegin();
+	assert(cit->second.size() == 11 && (cit + 9)->first == 0 && cit[2].first == 7);
+	assert(m.rend() - m.rbegin() == 10 && cit < m.rend());
+	assert((m.rend() - 1)->first == 0 && (--m.rend()).base() == m.begin() + 1);
+}
+
+static void setBackwards() {
+	ft::FlatSet<std::string> s;
+	s.insert("b");
+	s.insert("a");
+	s.insert("c");
+
+	ft::FlatSet<std::string>::reverse_iterator it = s.rbegin();
+	assert(*it == "c" && it->size() == 1 && *++it == "b" && *++it == "a" && ++it == s.rend());
+}
+
+/* Batches flagged sorted_unique go in without a sort. */
+static void sortedBatches() {
+	ft::FlatMap<int, int> m;
+	ft::pair<int, int> batch[] = { ft::make_pair(1, 1), ft::make_pair(3, 3), ft::make_pair(5, 5) };
+	ft::pair<int, int> more[] = { ft::make_pair(0, 0), ft::make_pair(3, 9), ft::make_pair(4, 4) };
+
+	m.insert(ft::sorted_unique, batch, batch + 3);
+	m.insert(ft::sorted_unique, more, more + 3);
+	assert(m.size() == 5 && m[3] == 3 && m.begin()->first == 0 && m.rbegin()->first == 5);
+
+	ft::FlatSet<int> s;
+	int keys[] = { 2, 4, 6 };
+	s.insert(ft::sorted_unique, keys, keys + 3);
+	assert(s.size() == 3 && *s.rbegin() == 6);
+}
+
+int main() {
+	emptyContainers();
+	mapBackwards();
+	setBackwards();
+	sortedBatches();
+	return 0;
+}
@@ -0,0 +1,89 @@
+/*
+** merge keeps each map's end() and leaves source's conflicting elements
+** where they were.
+** g++ -std=c++11 -I.. -fsanitize=address,undefined merge.cpp -o merge && ./merge
+*/
+#include "Map.hpp"
+#include "Set.hpp"
+#include <cassert>
+#include <string>
+
+template <class M>
+static void checkOrder(M& m) {
+	typename M::size_type n = 0;
+
+	for (typename M::iterator it = m.begin(); it != m.end(); ++it, ++n) {
+		typename M::iterator next = it;
+		if (++next != m.end())
+			assert(it->first < next->first);
+	}
+	assert(n == m.size());
+	if (!m.empty()) {
+		typename M::iterator last = m.end();
+		--last;
+		assert(++last == m.end());
+	}
+}
+
+/* Runs with source both smaller and larger than the target. */
+template <class M>
+static void mergeKeepsPlaces(int small, int large) {
+	M a, b;
+	for (int i = 0; i < small; ++i)
+		a[i * 3] = "a";
+	for (int i = 0; i < large; ++i)
+		b[i * 2] = "b";
+
+	typename M::iterator aEnd = a.end(), bEnd = b.end();
+	std::string *left = &b[0];
+	typename M::size_type both = 0;
+	for (int i = 0; i < large; ++i)
+		both += a.count(i * 2);
+
+	a.merge(b);
+	assert(a.end() == aEnd && b.end() == bEnd);
+	assert(b.size() == both && a.size() == small + large - both);
+	assert(&b[0] == left && *left == "b" && a[0] == "a");
+	checkOrder(a);
+	checkOrder(b);
+
+	a.insert(typename M::value_type(-1, "x"));
+	b.insert(typename M::value_type(-1, "y"));
+	b.erase(b.begin());
+	checkOrder(a);
+	checkOrder(b);
+	a.clear();
+	assert(b.count(0) == 1);
+	b.merge(a);
+	checkOrder(b);
+}
+
+static void mergeSets() {
+	ft::Set<int> a, b;
+	for (int i = 0; i < 10; ++i)
+		a.insert(i);
+	for (int i = 5; i < 500; ++i)
+		b.insert(i);
+
+	ft::Set<int>::iterator aEnd = a.end(), bEnd = b.end();
+	const int *kept = &*b.find(7);
+
+	a.merge(b);
+	assert(a.end() == aEnd && b.end() == bEnd);
+	assert(a.size() == 500 && b.size() == 5 && &*b.find(7) == kept);
+	a.merge(b);
+	assert(a.size() == 500 && b.size() == 5);
+}
+
+int main() {
+	mergeKeepsPlaces<ft::Map<int, std::string> >(10, 1000);
+	mergeKeepsPlaces<ft::Map<int, std::string> >(1000, 10);
+	mergeKeepsPlaces<ft::Map<int, std::string, std::less<int>,
+		std::allocator<std::pair<const int, std::string> >, ft::OrderStatistics> >(20, 300);
+	mergeKeepsPlaces<ft::Map<int, std::string, std::less<int>,
+		std::allocator<std::pair<const int, std::string> >, ft::Threaded> >(300, 20);
+	mergeKeepsPlaces<ft::Map<int, std::string, std::less<int>,
+		std::allocator<std::pair<const int, std::string> >, ft::Threaded> >(20, 300);
+	mergeSets();
+	return 0;
+}
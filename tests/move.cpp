@@ -0,0 +1,46 @@
+/*
+** Moves that cannot throw, so Vector relocates maps, vectors and pairs by
+** move instead of copying them.
+** g++ -std=c++11 -I.. -fsanitize=address,undefined move.cpp -o move && ./move
+*/
+#include "Map.hpp"
+#include "Set.hpp"
+#include "Vector.hpp"
+#include <cassert>
+#include <string>
+#include <type_traits>
+
+static_assert(std::is_nothrow_move_constructible<ft::pair<std::string, int> >::value, "pair move may throw");
+static_assert(std::is_nothrow_move_assignable<ft::pair<std::string, int> >::value, "pair move may throw");
+static_assert(!std::is_nothrow_move_constructible<ft::pair<const std::string, int> >::value, "a const string member is copied");
+static_assert(std::is_nothrow_move_constructible<ft::Vector<std::string> >::value, "Vector move may throw");
+static_assert(std::is_nothrow_move_assignable<ft::Vector<std::string> >::value, "Vector move may throw");
+static_assert(std::is_nothrow_move_constructible<ft::Map<int, int> >::value, "Map move may throw");
+static_assert(std::is_nothrow_move_assignable<ft::Map<int, int> >::value, "Map move may throw");
+static_assert(std::is_nothrow_move_constructible<ft::Set<int> >::value, "Set move may throw");
+static_assert(std::is_nothrow_move_assignable<ft::Set<int> >::value, "Set move may throw");
+
+/* Counts copies of an element that lives inside the relocated maps. */
+static int	copies = 0;
+
+struct Tracked {
+	int	value;
+
+	Tracked(int v = 0): value(v) {}
+	Tracked(const Tracked& other): value(other.value) { ++copies; }
+	Tracked& operator=(const Tracked& other) { value = other.value; ++copies; return *this; }
+};
+
+int main() {
+	ft::Vector<ft::Map<int, Tracked> > maps;
+
+	for (int i = 0; i < 100; ++i) {
+		ft::Map<int, Tracked> m;
+		m[i] = Tracked(i);
+		maps.push_back(std::move(m));
+	}
+	int before = copies;
+	maps.reserve(maps.capacity() * 4);
+	assert(copies == before && maps[99][99].value == 99);
+	return 0;
+}
@@ -0,0 +1,207 @@
+/*
+** Node handles outliving their container's nodes, and the slots they hold.
+** g++ -std=c++11 -I.. -pthread -fsanitize=address,undefined node_handle.cpp -o node_handle && ./node_handle
+*/
+#include "Map.hpp"
+#include "Set.hpp"
+#include <atomic>
+#include <cassert>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+static std::atomic<long>	live(0);
+
+/* Counts the bytes the maps hold from their allocator. */
+template <class T>
+struct Counting : std::allocator<T> {
+	template <class U> struct rebind { typedef Counting<U> other; };
+
+	Counting() {}
+	template <class U> Counting(const Counting<U>&) {}
+
+	T* allocate(std::size_t n) {
+		live.fetch_add(n * sizeof(T));
+		return std::allocator<T>::allocate(n);
+	}
+	void deallocate(T *p, std::size_t n) {
+		live.fetch_sub(n * sizeof(T));
+		std::allocator<T>::deallocate(p, n);
+	}
+};
+
+typedef ft::Map<int, std::string>	map_type;
+typedef ft::Set<std::string>		set_type;
+typedef ft::Map<int, std::string, std::less<int>, Counting<ft::pair<const int, std::string> > >	counted_type;
+
+static std::string value(int i) { return std::string(32, 'a' + i % 26); }
+
+static void fill(map_type& m, int n) {
+	for (int i = 0; i < n; ++i)
+		m[i] = value(i);
+}
+
+/* clear() gives the slabs back; the handle keeps its own alive. */
+static void outlivesClear() {
+	map_type m;
+	fill(m, 100);
+	map_type::node_type nh = m.extract(42);
+
+	m.clear();
+	fill(m, 50);
+	assert(nh.key() == 42 && nh.mapped() == value(42));
+	nh.key() = 1000;
+	assert(m.insert(std::move(nh)).inserted);
+	m.clear();
+	assert(m.empty());
+}
+
+static void outlivesOwner() {
+	map_type::node_type nh;
+	{
+		map_type m;
+		fill(m, 100);
+		nh = m.extract(7);
+	}
+	assert(nh.mapped() == value(7));
+
+	map_type other;
+	assert(other.insert(std::move(nh)).inserted && other[7] == value(7));
+}
+
+/* The handle follows the nodes, not the map object. */
+static void ownerMoves() {
+	map_type m;
+	fill(m, 100);
+	map_type::node_type nh = m.extract(3);
+	map_type moved(std::move(m));
+
+	assert(moved.insert(std::move(nh)).inserted && moved.size() == 100);
+	nh = moved.extract(4);
+	m = std::move(moved);
+	assert(m.insert(std::move(nh)).inserted && m.size() == 100);
+	nh = m.extract(5);
+	m.swap(moved);
+	assert(m.empty() && moved.size() == 99);
+	assert(m.insert(std::move(nh)).inserted && m[5] == value(5));
+	assert(m.size() == 1 && moved.count(5) == 0);
+}
+
+/* A node merged away from its map still goes back in. */
+static void ownerMerges() {
+	map_type a, b;
+	fill(a, 10);
+	for (int i = 5; i < 200; ++i)
+		b[i] = value(i);
+	map_type::node_type nh = a.extract(2);
+
+	b.merge(a);
+	a.clear();
+	assert(b.size() == 199 && b.count(2) == 0);
+	assert(b.insert(std::move(nh)).inserted && b.size() == 200);
+}
+
+/* Dropping a full handle destroys the value after its map is gone. */
+static void dropsLate() {
+	set_type::node_type nh;
+	{
+		set_type s;
+		for (int i = 0; i < 100; ++i)
+			s.insert(value(i) + char('0' + i % 10));
+		nh = s.extract(s.begin());
+	}
+	assert(!nh.empty());
+	{
+		set_type::node_type other;
+		other.swap(nh);
+		assert(nh.empty() && other.value().size() == 33);
+	}
+	assert(nh.empty());
+}
+
+/* Dropped handles give their slots back to the map they came from. */
+static void dropsReuseSlots() {
+	{
+		counted_type m;
+		for (int i = 0; i < 1000; ++i)
+			m[i] = value(i);
+		long held = live.load();
+
+		for (int i = 0; i < 200000; ++i) {
+			counted_type::node_type nh = m.extract(i % 1000);
+			assert(!nh.empty());
+			nh = counted_type::node_type();
+			m[i % 1000] = value(i);
+		}
+		assert(live.load() == held && m.size() == 1000);
+	}
+	assert(live.load() == 0);
+}
+
+/* A node moved to another map holds on to its own slab only. */
+static void movedNodeFreesSource() {
+	{
+		counted_type small;
+		long none = live.load();
+		{
+			counted_type big;
+			for (int i = 0; i < 100000; ++i)
+				big[i] = value(i);
+			small.insert(big.extract(0));
+			big.clear();
+			assert(live.load() - none < 64 * static_cast<long>(sizeof(Node_<counted_type::value_type>)));
+			for (int i = 0; i < 1000; ++i)
+				big[i] = value(i);
+			small.merge(big);
+		}
+		assert(small.size() == 1000 && small[0] == value(0));
+		small.clear();
+	}
+	assert(live.load() == 0);
+}
+
+/* Maps behind their own locks trade nodes from many threads; the slab
+** counts the trades share are atomic. */
+static void tradesAcrossThreads() {
+	{
+		counted_type maps[2];
+		std::mutex locks[2];
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < 4000; ++i)
+			maps[i & 1][i] = value(i);
+		for (int t = 0; t < 4; ++t)
+			threads.push_back(std::thread([&maps, &locks, t]() {
+				for (int i = 0; i < 5000; ++i) {
+					int from = (t + i) & 1, key = (i * 7919 + t) % 4000;
+					counted_type::node_type nh;
+					{
+						std::lock_guard<std::mutex> lock(locks[from]);
+						nh = maps[from].extract(key);
+					}
+					if (nh.empty() || i % 5 == 0)
+						continue;
+					std::lock_guard<std::mutex> lock(locks[!from]);
+					maps[!from].insert(std::move(nh));
+				}
+			}));
+		for (std::size_t t = 0; t < threads.size(); ++t)
+			threads[t].join();
+		assert(maps[0].size() + maps[1].size() < 4000);
+	}
+	assert(live.load() == 0);
+}
+
+int main() {
+	outlivesClear();
+	outlivesOwner();
+	ownerMoves();
+	ownerMerges();
+	dropsLate();
+	dropsReuseSlots();
+	movedNodeFreesSource();
+	tradesAcrossThreads();
+	return 0;
+}